@@ -32,9 +32,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "dal/dal_opt.h"
 #include "driver/virtual_os_driver.h"
 #include "core/virtual_os_config.h"
+#include "utils/stimer.h"
 
 #define FD_MAX_SIZE (VIRTUALOS_MAX_DEV_NUM + RESERVED_FDS)
 
@@ -42,6 +44,15 @@ struct fd_t {
 	struct drv_device *dev;
 	bool is_used;
 	size_t offset;
+	uint16_t aio_num; // 未完成的异步请求数
+	size_t rd_lent;	  // 借出的可读取字节数
+	size_t wr_lent;	  // 借出的可写入字节数
+
+	struct dal_poll_waiter *poll_waiter; // 登记等待就绪的任务 NULL表示没有
+	uint16_t poll_events;				 // 等待的事件
+
+	uint16_t cache_page; // 缓存页大小 0表示不使用缓存
+	size_t ra_next;		 // 顺序读取时下一次读取的偏移 用于判断是否预读
 };
 
 static struct fd_t fds[FD_MAX_SIZE] = { 0 };
@@ -77,6 +88,482 @@ static int check_fd(int fd, struct drv_device **dev)
 	return DAL_ERR_NONE;
 }
 
+/**
+ * @brief 查找打开了同一设备的其他文件 同一设备可以打开多次, 文件偏移与缓存由这些文件共用
+ * 
+ * @param dev 设备
+ * @param fd 排除的文件描述符
+ * @return int 文件描述符 没有时返回DAL_ERR_NOT_EXIST
+ */
+static int dal_dev_sibling(struct drv_device *dev, int fd)
+{
+	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
+		if (i != fd && fds[i].is_used && fds[i].dev == dev)
+			return i;
+	}
+	return DAL_ERR_NOT_EXIST;
+}
+
+/**
+ * @brief 设备是否有未完成的异步请求 包括同一设备的其他文件提交的请求
+ * 
+ * @param dev 设备
+ * @return true 有
+ * @return false 没有
+ */
+static bool dal_dev_aio_busy(struct drv_device *dev)
+{
+	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
+		if (fds[i].is_used && fds[i].dev == dev && fds[i].aio_num)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief 限制读写长度不超过设备大小
+ * 
+ * @param dev 设备
+ * @param offset 文件偏移
+ * @param len 长度
+ * @return size_t 实际长度
+ */
+static size_t dal_clamp_len(struct drv_device *dev, size_t offset, size_t len)
+{
+	if (dev->dev_size == 0)
+		return len;
+
+	if (offset >= dev->dev_size)
+		return 0;
+
+	return ((dev->dev_size - offset) < len) ? (dev->dev_size - offset) : len;
+}
+
+/************************************BLOCK CACHE************************************/
+
+static struct dal_cache_stat cache_stat = { 0 };
+
+#if VIRTUALOS_DAL_CACHE_PAGES
+
+#define CACHE_FILL_MAX (1 + VIRTUALOS_DAL_CACHE_READ_AHEAD) // 一次最多读取的页数
+
+struct dal_cache_page {
+	struct drv_device *dev; // 所属设备 NULL表示空闲 同一设备的所有文件共用
+	size_t index;			// 页号
+	uint32_t stamp;			// 最近使用的序号 用于淘汰最久未使用的页
+	bool loaded;			// 整页数据有效
+	uint16_t size;			// 页大小
+	uint16_t dirty_lo;		// 未写回的区间 [dirty_lo, dirty_hi)
+	uint16_t dirty_hi;
+	uint8_t data[VIRTUALOS_DAL_CACHE_PAGE_SIZE];
+};
+
+static struct dal_cache_page cache_pages[VIRTUALOS_DAL_CACHE_PAGES];
+static uint32_t cache_clock = 0;
+
+/**
+ * @brief 页的有效长度 最后一页可能不满
+ * 
+ * @param dev 设备
+ * @param page_size 页大小
+ * @param index 页号
+ * @return size_t 长度
+ */
+static inline size_t cache_page_len(struct drv_device *dev, size_t page_size, size_t index)
+{
+	return dal_clamp_len(dev, index * page_size, page_size);
+}
+
+/**
+ * @brief 查找已缓存的页
+ * 
+ * @param dev 设备
+ * @param index 页号
+ * @return struct dal_cache_page* 不存在时返回NULL
+ */
+static struct dal_cache_page *cache_find(struct drv_device *dev, size_t index)
+{
+	for (size_t i = 0; i < VIRTUALOS_DAL_CACHE_PAGES; i++) {
+		if (cache_pages[i].dev == dev && cache_pages[i].index == index) {
+			cache_pages[i].stamp = ++cache_clock;
+			return &cache_pages[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 把页中未写回的区间写入设备
+ * 
+ * @param page 页
+ * @return int 错误码
+ */
+static int cache_writeback(struct dal_cache_page *page)
+{
+	if (page->dirty_hi <= page->dirty_lo)
+		return DAL_ERR_NONE;
+
+	struct drv_device *dev = page->dev;
+	size_t offset = page->index * page->size + page->dirty_lo;
+	size_t len = page->dirty_hi - page->dirty_lo;
+
+	++cache_stat.bus_writes;
+	size_t ret = dev->file->opts->write(dev->file, page->data + page->dirty_lo, len, &offset);
+	if (ret != len)
+		return (int)ret < 0 ? (int)ret : DAL_ERR_EXCEPTION;
+
+	page->dirty_lo = page->dirty_hi = 0;
+	return DAL_ERR_NONE;
+}
+
+/**
+ * @brief 分配一页 没有空闲页时写回并淘汰最久未使用的页, 写回失败时改为淘汰最久未使用的干净页
+ * 
+ * @param dev 设备
+ * @param page_size 页大小
+ * @param index 页号
+ * @return struct dal_cache_page* 没有可淘汰的页时返回NULL
+ */
+static struct dal_cache_page *cache_alloc(struct drv_device *dev, size_t page_size, size_t index)
+{
+	struct dal_cache_page *page = &cache_pages[0];
+	struct dal_cache_page *clean = NULL;
+
+	for (size_t i = 0; i < VIRTUALOS_DAL_CACHE_PAGES; i++) {
+		struct dal_cache_page *p = &cache_pages[i];
+
+		if (!p->dev) {
+			page = p;
+			break;
+		}
+		if ((int32_t)(p->stamp - page->stamp) < 0)
+			page = p;
+		// 未读取的页可能是预读时刚分配的页, 不能作为替代
+		if (p->loaded && p->dirty_hi <= p->dirty_lo && (!clean || (int32_t)(p->stamp - clean->stamp) < 0))
+			clean = p;
+	}
+
+	if (page->dev) {
+		// 写回失败的页保留, 否则每次分配都会选中它
+		if (cache_writeback(page) != DAL_ERR_NONE)
+			page = clean;
+		if (!page)
+			return NULL;
+		++cache_stat.evictions;
+	}
+
+	page->dev = dev;
+	page->index = index;
+	page->stamp = ++cache_clock;
+	page->loaded = false;
+	page->size = page_size;
+	page->dirty_lo = page->dirty_hi = 0;
+
+	return page;
+}
+
+/**
+ * @brief 从设备读取从 index 开始的若干页 遇到已缓存的页停止预读
+ * 
+ * @param fd 文件描述符
+ * @param index 起始页号
+ * @param count 最多读取的页数
+ * @return struct dal_cache_page* 起始页 失败返回NULL
+ */
+static struct dal_cache_page *cache_fill(int fd, size_t index, size_t count)
+{
+	struct drv_device *dev = fds[fd].dev;
+	const struct file_operations *opts = dev->file->opts;
+	size_t page_size = fds[fd].cache_page;
+	struct dal_cache_page *pages[CACHE_FILL_MAX];
+	struct dal_iovec vec[CACHE_FILL_MAX];
+	size_t num = 0;
+
+	// 读取的页不能多于缓存页, 否则会淘汰刚读取的页
+	if (count > CACHE_FILL_MAX)
+		count = CACHE_FILL_MAX;
+	if (count > VIRTUALOS_DAL_CACHE_PAGES)
+		count = VIRTUALOS_DAL_CACHE_PAGES;
+
+	for (size_t i = 0; i < count; i++) {
+		size_t len = cache_page_len(dev, page_size, index + i);
+		if (!len)
+			break;
+
+		struct dal_cache_page *page = cache_find(dev, index + i);
+		if (page && i > 0)
+			break;
+
+		// 未写回的数据先写回, 读取后整页有效
+		if (page && cache_writeback(page) != DAL_ERR_NONE)
+			return NULL;
+
+		if (!page)
+			page = cache_alloc(dev, page_size, index + i);
+		if (!page)
+			break;
+
+		pages[num] = page;
+		vec[num].base = page->data;
+		vec[num].len = len;
+		++num;
+	}
+
+	if (!num)
+		return NULL;
+
+	size_t offset = index * page_size;
+
+	// 驱动支持分散读取时一次读取所有页
+	if (opts->readv && num > 1) {
+		++cache_stat.bus_reads;
+		size_t ret = opts->readv(dev->file, vec, num, &offset);
+		for (size_t i = 0; i < num && (int)ret >= 0 && ret >= vec[i].len; i++) {
+			pages[i]->loaded = true;
+			ret -= vec[i].len;
+		}
+	} else {
+		for (size_t i = 0; i < num; i++) {
+			++cache_stat.bus_reads;
+			if (opts->read(dev->file, vec[i].base, vec[i].len, &offset) != vec[i].len)
+				break;
+			pages[i]->loaded = true;
+		}
+	}
+
+	for (size_t i = 0; i < num; i++) {
+		if (!pages[i]->loaded)
+			pages[i]->dev = NULL; // 读取失败的页不保留
+	}
+
+	return pages[0]->loaded ? pages[0] : NULL;
+}
+
+/**
+ * @brief 不经过缓存直接读写设备 没有可用的缓存页时使用, 该区域不在缓存中
+ * 
+ * @param dev 设备
+ * @param buf 缓冲区
+ * @param len 大小
+ * @param offset 文件偏移 读写后增加
+ * @param is_write 是否为写入
+ * @return size_t 实际读写字节数 失败参考错误码
+ */
+static size_t cache_bypass(struct drv_device *dev, void *buf, size_t len, size_t *offset, bool is_write)
+{
+	const struct file_operations *opts = dev->file->opts;
+
+	if (is_write) {
+		++cache_stat.bus_writes;
+		return opts->write(dev->file, buf, len, offset);
+	}
+
+	++cache_stat.bus_reads;
+	return opts->read(dev->file, buf, len, offset);
+}
+
+/**
+ * @brief 经过缓存读取
+ * 
+ * @param fd 文件描述符
+ * @param buf 读缓冲区
+ * @param len 大小 已按设备大小截断
+ * @param offset 文件偏移 读取后增加
+ * @return size_t 实际读取字节数 失败参考错误码
+ */
+static size_t cache_read(int fd, uint8_t *buf, size_t len, size_t *offset)
+{
+	struct drv_device *dev = fds[fd].dev;
+	size_t page_size = fds[fd].cache_page;
+	bool sequential = *offset == fds[fd].ra_next && *offset; // 从头读取不视为顺序读取
+	size_t total = 0;
+
+	while (total < len) {
+		size_t index = *offset / page_size;
+		size_t lo = *offset % page_size;
+		size_t n = (page_size - lo) < (len - total) ? (page_size - lo) : (len - total);
+
+		struct dal_cache_page *page = cache_find(dev, index);
+		if (page && (page->loaded || (lo >= page->dirty_lo && lo + n <= page->dirty_hi))) {
+			++cache_stat.read_hits;
+		} else {
+			++cache_stat.read_misses;
+
+			// 没有可用的页时直接读取设备
+			if (!page && !cache_alloc(dev, page_size, index)) {
+				size_t ret = cache_bypass(dev, buf + total, n, offset, false);
+				if ((int)ret < 0)
+					return total ? total : ret;
+				total += ret;
+				if (ret < n)
+					break;
+				continue;
+			}
+
+			page = cache_fill(fd, index, sequential ? 1 + VIRTUALOS_DAL_CACHE_READ_AHEAD : 1);
+			if (!page)
+				return total ? total : (size_t)DAL_ERR_EXCEPTION;
+		}
+
+		memcpy(buf + total, page->data + lo, n);
+		total += n;
+		*offset += n;
+		sequential = true;
+	}
+
+	fds[fd].ra_next = *offset;
+	return total;
+}
+
+/**
+ * @brief 经过缓存写入
+ * 
+ * @param fd 文件描述符
+ * @param buf 写缓冲区
+ * @param len 大小 已按设备大小截断
+ * @param offset 文件偏移 写入后增加
+ * @return size_t 实际写入字节数 失败参考错误码
+ */
+static size_t cache_write(int fd, const uint8_t *buf, size_t len, size_t *offset)
+{
+	struct drv_device *dev = fds[fd].dev;
+	size_t page_size = fds[fd].cache_page;
+	size_t total = 0;
+
+	while (total < len) {
+		size_t index = *offset / page_size;
+		uint16_t lo = *offset % page_size;
+		uint16_t hi = lo + ((page_size - lo) < (len - total) ? (page_size - lo) : (len - total));
+
+		struct dal_cache_page *page = cache_find(dev, index);
+		if (page) {
+			++cache_stat.write_hits;
+		} else {
+			++cache_stat.write_misses;
+			page = cache_alloc(dev, page_size, index);
+		}
+
+		// 没有可用的页时直接写入设备
+		if (!page) {
+			size_t ret = cache_bypass(dev, (void *)(buf + total), hi - lo, offset, true);
+			if ((int)ret < 0)
+				return total ? total : ret;
+			total += ret;
+			if (ret < (size_t)(hi - lo))
+				break;
+			continue;
+		}
+
+		// 整页无效时只能合并相邻或重叠的区间, 否则先写回之前的区间
+		bool dirty = page->dirty_hi > page->dirty_lo;
+		if (dirty && !page->loaded && (hi < page->dirty_lo || lo > page->dirty_hi)) {
+			if (cache_writeback(page) != DAL_ERR_NONE)
+				return total ? total : (size_t)DAL_ERR_EXCEPTION;
+			dirty = false;
+		}
+
+		memcpy(page->data + lo, buf + total, hi - lo);
+		page->dirty_lo = (dirty && page->dirty_lo < lo) ? page->dirty_lo : lo;
+		page->dirty_hi = (dirty && page->dirty_hi > hi) ? page->dirty_hi : hi;
+		if (page->dirty_lo == 0 && page->dirty_hi == cache_page_len(dev, page_size, index))
+			page->loaded = true;
+
+		total += hi - lo;
+		*offset += hi - lo;
+	}
+
+	return total;
+}
+
+/**
+ * @brief 写回设备的所有脏页
+ * 
+ * @param dev 设备
+ * @param drop 写回后是否丢弃缓存页
+ * @return int 错误码
+ */
+static int cache_flush(struct drv_device *dev, bool drop)
+{
+	int ret = DAL_ERR_NONE;
+
+	for (size_t i = 0; i < VIRTUALOS_DAL_CACHE_PAGES; i++) {
+		if (cache_pages[i].dev != dev)
+			continue;
+
+		int err = cache_writeback(&cache_pages[i]);
+		if (err != DAL_ERR_NONE) {
+			ret = ret == DAL_ERR_NONE ? err : ret;
+			continue; // 写回失败的页保留
+		}
+
+		if (drop)
+			cache_pages[i].dev = NULL;
+	}
+
+	return ret;
+}
+
+#else
+
+static size_t cache_read(int fd, uint8_t *buf, size_t len, size_t *offset)
+{
+	(void)fd;
+	(void)buf;
+	(void)len;
+	(void)offset;
+	return DAL_ERR_EXCEPTION;
+}
+
+static size_t cache_write(int fd, const uint8_t *buf, size_t len, size_t *offset)
+{
+	(void)fd;
+	(void)buf;
+	(void)len;
+	(void)offset;
+	return DAL_ERR_EXCEPTION;
+}
+
+static int cache_flush(struct drv_device *dev, bool drop)
+{
+	(void)dev;
+	(void)drop;
+	return DAL_ERR_NONE;
+}
+
+#endif /* VIRTUALOS_DAL_CACHE_PAGES */
+
+/**
+ * @brief 读写设备 启用缓存时经过缓存
+ * 
+ * @param fd 文件描述符
+ * @param buf 缓冲区
+ * @param len 大小
+ * @param offset 文件偏移 读写后增加
+ * @param is_write 是否为写入
+ * @return size_t 实际读写字节数 失败参考错误码
+ */
+static size_t dal_dev_rw(int fd, void *buf, size_t len, size_t *offset, bool is_write)
+{
+	struct drv_device *dev = fds[fd].dev;
+	const struct file_operations *opts = dev->file->opts;
+
+	if (!(is_write ? opts->write : opts->read))
+		return DAL_ERR_EXCEPTION;
+
+	// 如果初始化驱动时设置了设备大小，则防止溢出
+	len = dal_clamp_len(dev, *offset, len);
+
+	if (fds[fd].cache_page) {
+		// 未完成的异步请求直接访问设备, 此时经过缓存可能读到写入之前的数据
+		if (dal_dev_aio_busy(dev))
+			return DAL_ERR_OCCUPIED;
+		return is_write ? cache_write(fd, buf, len, offset) : cache_read(fd, buf, len, offset);
+	}
+
+	return is_write ? opts->write(dev->file, buf, len, offset) : opts->read(dev->file, buf, len, offset);
+}
+
 int dal_open(const char *node_name)
 {
 	struct drv_device *dev = find_device(node_name);
@@ -98,7 +585,11 @@ int dal_open(const char *node_name)
 		return ret;
 	}
 
+	// 设备已启用缓存时新文件同样经过缓存, 否则会绕过其他文件未写回的数据
+	int sibling = dal_dev_sibling(dev, new_fd);
 	fds[new_fd].dev = dev;
+	fds[new_fd].cache_page = sibling >= 0 ? fds[sibling].cache_page : 0;
+	fds[new_fd].ra_next = 0;
 	return new_fd;
 }
 
@@ -109,13 +600,24 @@ int dal_close(int fd)
 	if (err != DAL_ERR_NONE)
 		return err;
 
+	if (fds[fd].aio_num || fds[fd].rd_lent || fds[fd].wr_lent)
+		return DAL_ERR_OCCUPIED;
+
 	if (!dev->file->opts->close)
 		return DAL_ERR_EXCEPTION;
 
-	int ret = dev->file->opts->close(dev->file);
+	// 写回失败时不关闭, 避免丢失数据; 设备还被其他文件打开时缓存继续由它们使用
+	int ret = dal_dev_sibling(dev, fd) >= 0 ? DAL_ERR_NONE : cache_flush(dev, true);
+	if (ret != DAL_ERR_NONE)
+		return ret;
+
+	ret = dev->file->opts->close(dev->file);
 	if (ret != DAL_ERR_NONE)
 		return ret;
 
+	fds[fd].poll_waiter = NULL;
+	fds[fd].cache_page = 0;
+
 	free_fd(fd);
 	return DAL_ERR_NONE;
 }
@@ -127,16 +629,7 @@ size_t dal_read(int fd, void *buf, size_t len)
 	if (err != DAL_ERR_NONE)
 		return err;
 
-	if (!dev->file->opts->read)
-		return DAL_ERR_EXCEPTION;
-
-	size_t real_len = len;
-
-	// 如果初始化驱动时设置了设备大小，则防止溢出
-	if (dev->dev_size > 0)
-		real_len = ((dev->dev_size - dev->offset) < len) ? (dev->dev_size - dev->offset) : len;
-
-	return dev->file->opts->read(dev->file, buf, real_len, &dev->offset);
+	return dal_dev_rw(fd, buf, len, &dev->offset, false);
 }
 
 size_t dal_write(int fd, void *buf, size_t len)
@@ -146,16 +639,7 @@ size_t dal_write(int fd, void *buf, size_t len)
 	if (err != DAL_ERR_NONE)
 		return err;
 
-	if (!dev->file->opts->write)
-		return DAL_ERR_EXCEPTION;
-
-	size_t real_len = len;
-
-	// 如果初始化驱动时设置了设备大小，则防止溢出
-	if (dev->dev_size > 0)
-		real_len = ((dev->dev_size - dev->offset) < len) ? (dev->dev_size - dev->offset) : len;
-
-	return dev->file->opts->write(dev->file, buf, real_len, &dev->offset);
+	return dal_dev_rw(fd, buf, len, &dev->offset, true);
 }
 
 int dal_ioctl(int fd, int cmd, void *arg)
@@ -212,10 +696,850 @@ int dal_lseek(int fd, int offset, enum dal_lseek_whence whence)
 	return dest_offset;
 }
 
-void dal_init(void)
+/**
+ * @brief 按设备大小截断多段缓冲区 并去掉长度为0的段
+ * 
+ * @param dev 设备
+ * @param offset 文件偏移
+ * @param iov 缓冲区数组
+ * @param iovcnt 段数
+ * @param out 截断后的缓冲区数组 至少 DAL_IOV_MAX 段
+ * @return int 截断后的段数 参数错误返回DAL_ERR_INVALID
+ */
+static int dal_clamp_iov(struct drv_device *dev, size_t offset, const struct dal_iovec *iov, int iovcnt,
+						 struct dal_iovec *out)
 {
-	for (uint16_t i = 0; i < FD_MAX_SIZE; i++) {
-		fds[i].is_used = i < RESERVED_FDS ? true : false;
-		fds[i].dev = NULL;
+	if (!iov || iovcnt <= 0 || iovcnt > DAL_IOV_MAX)
+		return DAL_ERR_INVALID;
+
+	size_t remain = dal_clamp_len(dev, offset, SIZE_MAX);
+	int num = 0;
+
+	for (int i = 0; i < iovcnt && remain; i++) {
+		if (!iov[i].len)
+			continue;
+
+		out[num].base = iov[i].base;
+		out[num].len = iov[i].len < remain ? iov[i].len : remain;
+		remain -= out[num].len;
+		++num;
+	}
+
+	return num;
+}
+
+/**
+ * @brief 分散/聚集读写 驱动未实现 readv/writev 或启用了缓存时逐段读写
+ * 
+ * @param fd 文件描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 段数
+ * @param offset 文件偏移 读写后增加
+ * @param is_write 是否为写入
+ * @return size_t 实际读写字节数 失败参考错误码
+ */
+static size_t dal_rw_vec(int fd, const struct dal_iovec *iov, int iovcnt, size_t *offset, bool is_write)
+{
+	struct drv_device *dev = fds[fd].dev;
+	const struct file_operations *opts = dev->file->opts;
+	size_t (*rw_f)(struct drv_file *, void *, size_t, size_t *) = is_write ? opts->write : opts->read;
+	size_t (*rwv_f)(struct drv_file *, const struct dal_iovec *, int, size_t *) = is_write ? opts->writev : opts->readv;
+
+	if (fds[fd].cache_page)
+		rwv_f = NULL;
+
+	if (!rw_f && !rwv_f)
+		return DAL_ERR_EXCEPTION;
+
+	struct dal_iovec vec[DAL_IOV_MAX];
+	int num = dal_clamp_iov(dev, *offset, iov, iovcnt, vec);
+	if (num <= 0)
+		return num;
+
+	if (rwv_f)
+		return rwv_f(dev->file, vec, num, offset);
+
+	size_t total = 0;
+	for (int i = 0; i < num; i++) {
+		size_t ret = dal_dev_rw(fd, vec[i].base, vec[i].len, offset, is_write);
+		if ((int)ret < 0)
+			return total ? total : ret; // 已经读写的部分有效
+
+		total += ret;
+		if (ret < vec[i].len)
+			break;
 	}
-}
\ No newline at end of file
+
+	return total;
+}
+
+size_t dal_readv(int fd, const struct dal_iovec *iov, int iovcnt)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	return dal_rw_vec(fd, iov, iovcnt, &dev->offset, false);
+}
+
+size_t dal_writev(int fd, const struct dal_iovec *iov, int iovcnt)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	return dal_rw_vec(fd, iov, iovcnt, &dev->offset, true);
+}
+
+size_t dal_pread(int fd, void *buf, size_t len, size_t offset)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	// 使用局部的偏移, 不影响 dal_read/dal_write 的文件偏移
+	return dal_dev_rw(fd, buf, len, &offset, false);
+}
+
+size_t dal_pwrite(int fd, void *buf, size_t len, size_t offset)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	return dal_dev_rw(fd, buf, len, &offset, true);
+}
+
+int dal_read_acquire(int fd, void **buf, size_t *len)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!buf || !len)
+		return DAL_ERR_INVALID;
+
+	if (!dev->file->opts->read_acquire || !dev->file->opts->read_release)
+		return DAL_ERR_EXCEPTION;
+
+	if (fds[fd].rd_lent)
+		return DAL_ERR_OCCUPIED;
+
+	err = dev->file->opts->read_acquire(dev->file, buf, len);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	fds[fd].rd_lent = *len;
+	return DAL_ERR_NONE;
+}
+
+int dal_read_release(int fd, size_t len)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!fds[fd].rd_lent)
+		return DAL_ERR_UNAVAILABLE;
+
+	if (len > fds[fd].rd_lent)
+		len = fds[fd].rd_lent;
+
+	fds[fd].rd_lent = 0;
+	return dev->file->opts->read_release(dev->file, len);
+}
+
+int dal_write_reserve(int fd, void **buf, size_t *len)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!buf || !len)
+		return DAL_ERR_INVALID;
+
+	if (!dev->file->opts->write_reserve || !dev->file->opts->write_commit)
+		return DAL_ERR_EXCEPTION;
+
+	if (fds[fd].wr_lent)
+		return DAL_ERR_OCCUPIED;
+
+	err = dev->file->opts->write_reserve(dev->file, buf, len);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	fds[fd].wr_lent = *len;
+	return DAL_ERR_NONE;
+}
+
+int dal_write_commit(int fd, size_t len)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!fds[fd].wr_lent)
+		return DAL_ERR_UNAVAILABLE;
+
+	if (len > fds[fd].wr_lent)
+		len = fds[fd].wr_lent;
+
+	fds[fd].wr_lent = 0;
+	return dev->file->opts->write_commit(dev->file, len);
+}
+
+/**
+ * @brief 把数据写入输出设备 输出设备只支持借出空间时拷贝到借出的空间
+ * 
+ * @param out 输出设备
+ * @param buf 数据
+ * @param len 大小
+ * @return size_t 实际写入字节数 失败参考错误码
+ */
+static size_t dal_splice_write(struct drv_device *out, void *buf, size_t len)
+{
+	const struct file_operations *opts = out->file->opts;
+
+	if (opts->write)
+		return opts->write(out->file, buf, dal_clamp_len(out, out->offset, len), &out->offset);
+
+	void *space;
+	int err = opts->write_reserve(out->file, &space, &len);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	memcpy(space, buf, len);
+	opts->write_commit(out->file, len);
+
+	return len;
+}
+
+/**
+ * @brief 搬运一次数据 最多为一段借出的区域或一个中转缓冲区
+ * 
+ * @param in 输入设备
+ * @param out 输出设备
+ * @param len 最多搬运的字节数
+ * @return size_t 实际搬运字节数 失败参考错误码
+ */
+static size_t dal_splice_once(struct drv_device *in, struct drv_device *out, size_t len)
+{
+	const struct file_operations *in_opts = in->file->opts;
+	const struct file_operations *out_opts = out->file->opts;
+	bool out_lend = out_opts->write_reserve && out_opts->write_commit;
+	void *buf;
+	size_t moved;
+	int err;
+
+	if (!out_opts->write && !out_lend)
+		return DAL_ERR_EXCEPTION;
+
+	// 借出输入设备的数据, 直接写入输出设备, 只移除已写入的部分
+	if (in_opts->read_acquire && in_opts->read_release) {
+		err = in_opts->read_acquire(in->file, &buf, &len);
+		if (err != DAL_ERR_NONE || !len)
+			return err;
+
+		moved = dal_splice_write(out, buf, len);
+		in_opts->read_release(in->file, (int)moved < 0 ? 0 : moved);
+		return moved;
+	}
+
+	if (!in_opts->read)
+		return DAL_ERR_EXCEPTION;
+
+	// 借出输出设备的空间, 直接读取到其中
+	if (out_lend) {
+		err = out_opts->write_reserve(out->file, &buf, &len);
+		if (err != DAL_ERR_NONE || !len)
+			return err;
+
+		moved = in_opts->read(in->file, buf, dal_clamp_len(in, in->offset, len), &in->offset);
+		out_opts->write_commit(out->file, (int)moved < 0 ? 0 : moved);
+		return moved;
+	}
+
+	// 两端都不支持借出时经过中转缓冲区, 流设备可能只写入一部分, 已读出的数据无处存放
+	if (!out->dev_size)
+		return DAL_ERR_NOT_SUPPORT;
+
+	// 存储设备在剩余空间内总是全部写入, 只读取剩余空间能容纳的部分
+	uint8_t chunk[DAL_SPLICE_CHUNK];
+	len = dal_clamp_len(out, out->offset, len < sizeof(chunk) ? len : sizeof(chunk));
+	if (!len)
+		return 0;
+
+	moved = in_opts->read(in->file, chunk, dal_clamp_len(in, in->offset, len), &in->offset);
+	if ((int)moved <= 0)
+		return moved;
+
+	return dal_splice_write(out, chunk, moved);
+}
+
+size_t dal_splice(int fd_in, int fd_out, size_t len)
+{
+	struct drv_device *in, *out;
+	int err = check_fd(fd_in, &in);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	err = check_fd(fd_out, &out);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (fds[fd_in].rd_lent || fds[fd_out].wr_lent)
+		return DAL_ERR_OCCUPIED;
+
+	// 未完成的异步请求同样在访问设备, 搬运会与其交错
+	if (dal_dev_aio_busy(in) || dal_dev_aio_busy(out))
+		return DAL_ERR_OCCUPIED;
+
+	// 直接访问设备, 先写回并丢弃缓存
+	err = cache_flush(in, true);
+	if (err == DAL_ERR_NONE)
+		err = cache_flush(out, true);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	size_t total = 0;
+	while (total < len) {
+		size_t moved = dal_splice_once(in, out, len - total);
+		if ((int)moved < 0)
+			return total ? total : moved; // 已经搬运的部分有效
+
+		if (!moved)
+			break;
+
+		total += moved;
+	}
+
+	return total;
+}
+
+/**
+ * @brief 查询设备当前的就绪事件 驱动未实现 poll 时视为一直可读写
+ * 
+ * @param dev 设备
+ * @return uint16_t 就绪事件
+ */
+static uint16_t dal_poll_dev(struct drv_device *dev)
+{
+	if (!dev->file->opts->poll)
+		return DAL_POLLIN | DAL_POLLOUT;
+
+	int ret = dev->file->opts->poll(dev->file);
+	return ret < 0 ? DAL_POLLERR : (uint16_t)ret;
+}
+
+/**
+ * @brief 等待就绪的任务 一个任务一次 dal_poll 登记的所有文件共用一个等待者
+ */
+struct dal_poll_waiter {
+	stimer_handle owner;		  // 使用此等待者的任务 NULL表示空闲
+	volatile stimer_handle armed; // 等待唤醒的任务 唤醒或撤销后为NULL
+	stimer_timer_handle timer;	  // 超时定时器 第一次使用时创建
+};
+
+static struct dal_poll_waiter poll_waiters[DAL_POLL_MAX_WAITER];
+
+/**
+ * @brief 唤醒等待者的任务 每次登记只唤醒一次 可在中断中调用
+ * 
+ * @param w 等待者
+ */
+static void dal_poll_wake(struct dal_poll_waiter *w)
+{
+	stimer_handle task = __atomic_exchange_n(&w->armed, NULL, __ATOMIC_ACQ_REL);
+	if (task)
+		stimer_task_notify(task);
+}
+
+/**
+ * @brief 等待超时 唤醒登记的任务
+ * 
+ * @param arg 等待者
+ */
+static void dal_poll_timeout(void *arg)
+{
+	dal_poll_wake((struct dal_poll_waiter *)arg);
+}
+
+/**
+ * @brief 取得任务的等待者 优先使用任务自己的, 其次是空闲的, 最后是已唤醒但尚未再次查询的
+ * 
+ * @param task 任务
+ * @return struct dal_poll_waiter* 都在等待时返回NULL
+ */
+static struct dal_poll_waiter *dal_poll_waiter_get(stimer_handle task)
+{
+	struct dal_poll_waiter *unused = NULL, *woken = NULL;
+
+	for (uint8_t i = 0; i < DAL_POLL_MAX_WAITER; i++) {
+		struct dal_poll_waiter *w = &poll_waiters[i];
+
+		if (w->owner == task)
+			return w;
+		if (!w->owner && !unused)
+			unused = w;
+		else if (w->owner && !woken && !__atomic_load_n(&w->armed, __ATOMIC_ACQUIRE))
+			woken = w;
+	}
+
+	return unused ? unused : woken;
+}
+
+/**
+ * @brief 撤销等待者的登记 停止超时定时器, 并清除所有文件上对它的登记
+ * 
+ * @param w 等待者
+ */
+static void dal_poll_disarm(struct dal_poll_waiter *w)
+{
+	__atomic_store_n(&w->armed, NULL, __ATOMIC_RELEASE);
+	if (w->timer)
+		stimer_timer_stop(w->timer);
+
+	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
+		if (fds[i].poll_waiter == w)
+			__atomic_store_n(&fds[i].poll_waiter, NULL, __ATOMIC_RELEASE);
+	}
+}
+
+int dal_poll(struct dal_pollfd *pfds, size_t n, int timeout_ms)
+{
+	if (!pfds || !n)
+		return DAL_ERR_INVALID;
+
+	// 只有在任务中才能登记等待
+	stimer_handle self = timeout_ms ? stimer_self() : NULL;
+	struct dal_poll_waiter *w = NULL;
+	int ready = 0;
+
+	if (self) {
+		w = dal_poll_waiter_get(self);
+		if (!w)
+			return DAL_ERR_OCCUPIED;
+
+		// 先撤销上一次的登记, 上一次登记的文件可能与本次不同
+		dal_poll_disarm(w);
+		w->owner = self;
+
+		// 其他任务正在等待同一个文件时拒绝, 不覆盖对方的登记
+		for (size_t i = 0; i < n; i++) {
+			if (pfds[i].fd < RESERVED_FDS || pfds[i].fd >= FD_MAX_SIZE)
+				continue;
+
+			struct dal_poll_waiter *other = fds[pfds[i].fd].poll_waiter;
+			if (other && __atomic_load_n(&other->armed, __ATOMIC_ACQUIRE)) {
+				w->owner = NULL;
+				return DAL_ERR_OCCUPIED;
+			}
+		}
+
+		// 先登记再查询, 查询之后到来的通知不会丢失
+		__atomic_store_n(&w->armed, self, __ATOMIC_RELEASE);
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		struct drv_device *dev;
+		uint16_t events = pfds[i].events | DAL_POLLERR;
+
+		if (check_fd(pfds[i].fd, &dev) != DAL_ERR_NONE) {
+			pfds[i].revents = DAL_POLLERR;
+			++ready;
+			continue;
+		}
+
+		if (w) {
+			struct fd_t *f = &fds[pfds[i].fd];
+			f->poll_events = events;
+			__atomic_store_n(&f->poll_waiter, w, __ATOMIC_RELEASE);
+		}
+
+		pfds[i].revents = dal_poll_dev(dev) & events;
+		if (pfds[i].revents)
+			++ready;
+	}
+
+	if (!w)
+		return ready;
+
+	// 已经就绪, 撤销本次的全部登记并释放等待者
+	if (ready) {
+		dal_poll_disarm(w);
+		w->owner = NULL;
+		return ready;
+	}
+
+	// 每个等待者一个超时定时器, 超时后唤醒一次, 其余文件上的登记随之失效
+	if (timeout_ms > 0) {
+		if (!w->timer)
+			w->timer = stimer_timer_create(dal_poll_timeout, w);
+		if (w->timer)
+			stimer_timer_start(w->timer, (uint32_t)timeout_ms);
+	}
+
+	return 0;
+}
+
+void dal_poll_notify(struct drv_file *file, uint16_t events)
+{
+	if (!file)
+		return;
+
+	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
+		struct fd_t *f = &fds[i];
+		if (!f->is_used || !f->dev || f->dev->file != file || !(f->poll_events & events))
+			continue;
+
+		struct dal_poll_waiter *w = __atomic_load_n(&f->poll_waiter, __ATOMIC_ACQUIRE);
+		if (w)
+			dal_poll_wake(w);
+	}
+}
+
+int dal_cache_enable(int fd, size_t page_size)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!VIRTUALOS_DAL_CACHE_PAGES || dev->dev_size == 0 || !dev->file->opts->read || !dev->file->opts->write)
+		return DAL_ERR_EXCEPTION;
+
+	if (page_size > VIRTUALOS_DAL_CACHE_PAGE_SIZE)
+		return DAL_ERR_INVALID;
+
+	if (dal_dev_aio_busy(dev))
+		return DAL_ERR_OCCUPIED;
+
+	// 修改页大小前写回并丢弃原来的缓存
+	err = cache_flush(dev, true);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	// 缓存页按设备查找, 同一设备的所有文件使用相同的页大小
+	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
+		if (fds[i].is_used && fds[i].dev == dev) {
+			fds[i].cache_page = page_size;
+			fds[i].ra_next = 0;
+		}
+	}
+	return DAL_ERR_NONE;
+}
+
+int dal_sync(int fd)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	return cache_flush(dev, false);
+}
+
+void dal_cache_get_stat(struct dal_cache_stat *stat)
+{
+	if (stat)
+		*stat = cache_stat;
+}
+
+void dal_cache_reset_stat(void)
+{
+	memset(&cache_stat, 0, sizeof(cache_stat));
+}
+
+/************************************ASYNC I/O************************************/
+
+static struct stimer_task aio_tcb;
+static stimer_handle aio_task = NULL;
+
+static struct dal_aio_req *aio_pending_head = NULL; // 等待驱动处理的请求 按提交顺序
+static struct dal_aio_req *aio_pending_tail = NULL;
+static struct dal_aio_req *aio_running = NULL; // 驱动正在处理的请求
+
+/**
+ * @brief 用同步接口完成请求 用于未实现 submit 的驱动
+ * 
+ * @param dev 设备
+ * @param req 请求
+ * @return int 结果
+ */
+static int dal_aio_sync(struct drv_device *dev, struct dal_aio_req *req)
+{
+	const struct file_operations *opts = dev->file->opts;
+	size_t offset = req->offset;
+
+	switch (req->op) {
+	case DAL_AIO_READ:
+		return opts->read ? (int)opts->read(dev->file, req->buf, req->len, &offset) : DAL_ERR_EXCEPTION;
+
+	case DAL_AIO_WRITE:
+		return opts->write ? (int)opts->write(dev->file, req->buf, req->len, &offset) : DAL_ERR_EXCEPTION;
+
+	case DAL_AIO_IOCTL:
+		return opts->ioctl ? opts->ioctl(dev->file, req->cmd, req->arg) : DAL_ERR_EXCEPTION;
+
+	default:
+		return DAL_ERR_INVALID;
+	}
+}
+
+/**
+ * @brief 取回已完成的请求并调用回调
+ */
+static void dal_aio_reap(void)
+{
+	struct dal_aio_req **pp = &aio_running;
+
+	while (*pp) {
+		struct dal_aio_req *req = *pp;
+
+		if (__atomic_load_n(&req->state, __ATOMIC_ACQUIRE) != DAL_AIO_DONE) {
+			pp = &req->next;
+			continue;
+		}
+
+		*pp = req->next;
+		--fds[req->fd].aio_num;
+		req->state = DAL_AIO_IDLE;
+		if (req->done_f)
+			req->done_f(req); // 回调中可能再次提交, 放在出队之后
+	}
+}
+
+/**
+ * @brief 异步请求的工作任务 由提交与完成唤醒, 并以 DAL_AIO_POLL_MS 为周期兜底
+ */
+static void dal_aio_task(void)
+{
+	struct drv_device *busy[FD_MAX_SIZE]; // 本次已经拒绝请求的设备, 其后的请求留到下次, 保持提交顺序
+	uint8_t busy_num = 0;
+	bool synced = false;
+
+	dal_aio_reap();
+
+	struct dal_aio_req **pp = &aio_pending_head;
+	struct dal_aio_req *prev = NULL;
+
+	while (*pp) {
+		struct dal_aio_req *req = *pp;
+		struct drv_device *dev = fds[req->fd].dev;
+		bool skip = false;
+
+		for (uint8_t i = 0; i < busy_num; i++)
+			skip |= busy[i] == dev;
+
+		// 同步驱动会占用主循环, 每次只处理一个, 之后重新排队
+		if (skip || (!dev->file->opts->submit && synced)) {
+			prev = req;
+			pp = &req->next;
+			continue;
+		}
+
+		req->state = DAL_AIO_RUNNING;
+
+		int ret = DAL_ERR_NONE;
+		if (dev->file->opts->submit) {
+			ret = dev->file->opts->submit(dev->file, req);
+			if (ret == DAL_ERR_OCCUPIED) {
+				req->state = DAL_AIO_QUEUED;
+				busy[busy_num++] = dev;
+				prev = req;
+				pp = &req->next;
+				continue;
+			}
+		} else {
+			ret = dal_aio_sync(dev, req);
+			synced = true;
+		}
+
+		// 移出等待队列, 放入处理中的队列
+		*pp = req->next;
+		if (aio_pending_tail == req)
+			aio_pending_tail = prev;
+		req->next = aio_running;
+		aio_running = req;
+
+		// 驱动拒绝请求或同步完成
+		if (ret != DAL_ERR_NONE || !dev->file->opts->submit)
+			dal_aio_complete(req, ret);
+	}
+
+	dal_aio_reap();
+
+	if (synced && aio_pending_head)
+		stimer_task_notify(aio_task);
+	else if (!aio_pending_head && !aio_running)
+		stimer_task_suspend(aio_task);
+}
+
+/**
+ * @brief 加入等待队列并唤醒工作任务
+ * 
+ * @param req 请求
+ * @param fd 文件描述符
+ * @return int 错误码
+ */
+static int dal_aio_enqueue(struct dal_aio_req *req, int fd)
+{
+	// 工作任务由 dal_init 创建
+	if (!aio_task)
+		return DAL_ERR_EXCEPTION;
+
+	req->fd = fd;
+	req->result = 0;
+	req->state = DAL_AIO_QUEUED;
+	req->next = NULL;
+
+	if (aio_pending_tail)
+		aio_pending_tail->next = req;
+	else
+		aio_pending_head = req;
+	aio_pending_tail = req;
+
+	++fds[fd].aio_num;
+	stimer_task_resume(aio_task);
+	stimer_task_notify(aio_task);
+
+	return DAL_ERR_NONE;
+}
+
+/**
+ * @brief 提交读写请求
+ * 
+ * @param req 请求
+ * @param fd 文件描述符
+ * @param op 读或写
+ * @param buf 缓冲区
+ * @param len 大小
+ * @param done_f 完成回调
+ * @return int 错误码
+ */
+static int dal_submit_rw(struct dal_aio_req *req, int fd, enum dal_aio_op op, void *buf, size_t len, dal_aio_cb done_f)
+{
+	struct drv_device *dev;
+
+	if (!req || (req->state != DAL_AIO_IDLE && req->state != DAL_AIO_DONE))
+		return DAL_ERR_INVALID;
+
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	const struct file_operations *opts = dev->file->opts;
+	if (!opts->submit && !(op == DAL_AIO_READ ? opts->read : opts->write))
+		return DAL_ERR_EXCEPTION;
+
+	// 异步请求直接访问设备, 先写回并丢弃缓存
+	err = cache_flush(dev, true);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	// 提交时确定偏移, 连续提交的请求读写相邻的区域
+	req->op = op;
+	req->buf = buf;
+	req->offset = dev->offset;
+	req->len = dal_clamp_len(dev, dev->offset, len);
+	req->done_f = done_f;
+	dev->offset += req->len;
+
+	return dal_aio_enqueue(req, fd);
+}
+
+int dal_submit_read(struct dal_aio_req *req, int fd, void *buf, size_t len, dal_aio_cb done_f)
+{
+	return dal_submit_rw(req, fd, DAL_AIO_READ, buf, len, done_f);
+}
+
+int dal_submit_write(struct dal_aio_req *req, int fd, void *buf, size_t len, dal_aio_cb done_f)
+{
+	return dal_submit_rw(req, fd, DAL_AIO_WRITE, buf, len, done_f);
+}
+
+int dal_submit_ioctl(struct dal_aio_req *req, int fd, int cmd, void *arg, dal_aio_cb done_f)
+{
+	struct drv_device *dev;
+
+	if (!req || (req->state != DAL_AIO_IDLE && req->state != DAL_AIO_DONE))
+		return DAL_ERR_INVALID;
+
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!dev->file->opts->submit && !dev->file->opts->ioctl)
+		return DAL_ERR_EXCEPTION;
+
+	req->op = DAL_AIO_IOCTL;
+	req->cmd = cmd;
+	req->arg = arg;
+	req->done_f = done_f;
+
+	return dal_aio_enqueue(req, fd);
+}
+
+bool dal_aio_done(struct dal_aio_req *req)
+{
+	if (!req)
+		return true;
+
+	enum dal_aio_state state = __atomic_load_n(&req->state, __ATOMIC_ACQUIRE);
+	return state == DAL_AIO_DONE || state == DAL_AIO_IDLE;
+}
+
+void dal_aio_complete(struct dal_aio_req *req, int result)
+{
+	if (!req)
+		return;
+
+	req->result = result;
+	__atomic_store_n(&req->state, DAL_AIO_DONE, __ATOMIC_RELEASE);
+	stimer_task_notify(aio_task);
+}
+
+void dal_init(void)
+{
+	for (uint16_t i = 0; i < FD_MAX_SIZE; i++) {
+		fds[i].is_used = i < RESERVED_FDS ? true : false;
+		fds[i].dev = NULL;
+		fds[i].aio_num = 0;
+		fds[i].rd_lent = 0;
+		fds[i].wr_lent = 0;
+		fds[i].poll_waiter = NULL;
+		fds[i].poll_events = 0;
+		fds[i].cache_page = 0;
+		fds[i].ra_next = 0;
+	}
+
+#if VIRTUALOS_DAL_CACHE_PAGES
+	memset(cache_pages, 0, sizeof(cache_pages));
+#endif
+
+	// 调度器重新初始化后原来的定时器已失效
+	memset(poll_waiters, 0, sizeof(poll_waiters));
+
+	aio_pending_head = NULL;
+	aio_pending_tail = NULL;
+	aio_running = NULL;
+
+	// 在调度器初始化之后创建, 否则 stimer_init 会清除已创建的任务
+	// 没有请求时挂起, 不使用异步读写时不会周期唤醒
+	static const struct stimer_task_attr attr = {
+		.name = "dal_aio",
+		.task_f = dal_aio_task,
+		.period_ms = DAL_AIO_POLL_MS,
+	};
+	if (!aio_task)
+		aio_task = stimer_task_create_static(&aio_tcb, &attr);
+	stimer_task_suspend(aio_task);
+}
@@ -32,6 +32,7 @@
 
 #include "utils/crc.h"
 #include "utils/queue.h"
+#include "utils/stimer.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -73,7 +74,8 @@ struct req_info {
 	struct mb_mst_request request; // 请求信息
 
 	uint32_t to_timeout;  // 超时时间
-	uint32_t cur_ctr;	  // 当前计数器
+	uint32_t start_ms;	  // 本次发送的时刻
+	bool sent;			  // 已发送 等待响应或超时
 	uint8_t repeat_times; // 重发次数
 	uint8_t reg_len;	  // 写功能码时的寄存器长度
 
@@ -341,19 +343,17 @@ static void _dispatch_rtu_msg(mb_mst_handle handle)
 /**
  * @brief 检查当前请求回复是否超时
  * 
- * @param handle 主机句柄
- * @param request 请求包
+ * @param req_info_ptr 已发送的请求
  * @return true 超时
  * @return false 未超时
  */
-static bool check_timeout(size_t period, struct req_info *req_info_ptr)
+static bool check_timeout(struct req_info *req_info_ptr)
 {
 	if (!req_info_ptr)
 		return true;
 
-	req_info_ptr->cur_ctr += period; // 累加超时时间
-	if (req_info_ptr->cur_ctr > req_info_ptr->to_timeout) {
-		req_info_ptr->cur_ctr = 0;	  // 超时后重置计时器
+	if (stimer_now_ms() - req_info_ptr->start_ms > req_info_ptr->to_timeout) {
+		req_info_ptr->sent = false;	  // 超时后重置计时器
 		req_info_ptr->repeat_times++; // 增加重发次数标志
 		return true;				  // 超时
 	}
@@ -424,13 +424,14 @@ static void master_write(mb_mst_handle handle)
 	// 不重发
 	if (NO_RETRIES) {
 		// 初始包直接发
-		if (req_info_ptr->cur_ctr == 0 && handle->sem) {
-			handle->sem--;								// 获取信号量
-			req_info_ptr->cur_ctr += handle->period_ms; // 累加超时时间
-			req_info_ptr->repeat_times++;				// 增加重发次数标志
-			_request_pdu(handle, req_info_ptr);			// 发送第一包请求
+		if (!req_info_ptr->sent && handle->sem) {
+			handle->sem--;							  // 获取信号量
+			req_info_ptr->start_ms = stimer_now_ms(); // 开始计时
+			req_info_ptr->sent = true;				  // 已发送
+			req_info_ptr->repeat_times++;			  // 增加重发次数标志
+			_request_pdu(handle, req_info_ptr);		  // 发送第一包请求
 			return;
-		} else if (check_timeout(handle->period_ms, req_info_ptr)) {
+		} else if (req_info_ptr->sent && check_timeout(req_info_ptr)) {
 			// 超时后从队列中移除
 
 			struct req_info *req_info_ptr = NULL;
@@ -454,14 +455,15 @@ static void master_write(mb_mst_handle handle)
 			// 未重发完
 
 			// 初始包直接发
-			if (req_info_ptr->cur_ctr == 0 && !handle->sem) {
+			if (!req_info_ptr->sent && !handle->sem) {
 				handle->sem++;
-				req_info_ptr->cur_ctr += handle->period_ms; // 累加超时时间
-				req_info_ptr->repeat_times++;				// 增加重发次数标志
-				_request_pdu(handle, req_info_ptr);			// 发送第一包请求
+				req_info_ptr->start_ms = stimer_now_ms(); // 开始计时
+				req_info_ptr->sent = true;				  // 已发送
+				req_info_ptr->repeat_times++;			  // 增加重发次数标志
+				_request_pdu(handle, req_info_ptr);		  // 发送第一包请求
 				return;
-			} else {
-				check_timeout(handle->period_ms, req_info_ptr); // 检查超时
+			} else if (req_info_ptr->sent) {
+				check_timeout(req_info_ptr); // 检查超时
 			}
 		} else {
 			// 重发完后 从队列中移除
@@ -623,7 +625,7 @@ void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, ui
 
 	memset(new_req_info, 0, sizeof(struct req_info));
 	memcpy(&new_req_info->request, request, sizeof(struct mb_mst_request));
-	new_req_info->cur_ctr = 0;
+	new_req_info->sent = false;
 	new_req_info->repeat_times = 0;
 	new_req_info->to_timeout = request->timeout_ms;
 	new_req_info->reg_len = reg_len;
@@ -53,21 +53,51 @@ static void register_drivers(void)
 	}
 }
 
+extern const struct drv_device_desc __start_early_device[];
+extern const struct drv_device_desc __stop_early_device[];
+
+static void register_devices(void)
+{
+	driver_register_static(__start_early_device, __stop_early_device - __start_early_device);
+}
+
+extern const struct stimer_task_desc __start_early_task[];
+extern const struct stimer_task_desc __stop_early_task[];
+
+static void register_tasks(void)
+{
+	size_t task_count = __stop_early_task - __start_early_task;
+
+	for (size_t i = 0; i < task_count; i++)
+		stimer_task_create_static(__start_early_task[i].tcb, &__start_early_task[i].attr);
+}
+
 void virtual_os_init(struct timer_port *port)
 {
 	driver_manage_init();
 
-	register_drivers();
+	register_devices();
 
-	dal_init();
+	register_drivers();
 
 	virtual_os_assert(stimer_init(port));
 
+	dal_init(); // 创建异步读写的工作任务, 需要在调度器初始化之后
+
+	register_tasks();
+
 #if VIRTUALOS_SHELL_ENABLE
 	// 使能Shell
 	extern void virtual_os_shell_init(void);
 	extern void virtual_os_shell_task(void);
-	stimer_task_create(virtual_os_shell_init, virtual_os_shell_task, VIRTUALOS_SHELL_PRIOD_MS);
+	static struct stimer_task shell_tcb;
+	static const struct stimer_task_attr shell_attr = {
+		.name = "shell",
+		.init_f = virtual_os_shell_init,
+		.task_f = virtual_os_shell_task,
+		.period_ms = VIRTUALOS_SHELL_PRIOD_MS,
+	};
+	stimer_task_create_static(&shell_tcb, &shell_attr);
 #endif
 
 }
\ No newline at end of file
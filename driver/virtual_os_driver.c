@@ -33,13 +33,158 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "utils/string_hash.h"
+#include "utils/robin_hash.h"
 #include "driver/virtual_os_driver.h"
 #include "core/virtual_os_defines.h"
 #include "core/virtual_os_config.h"
 #include "core/virtual_os_defines.h"
 
-static struct hash_table driver_table = { 0 };
+#define DRV_STATIC_SLOTS (4 * VIRTUALOS_MAX_DEV_NUM) // 静态设备哈希表的槽位数 越大越容易找到无冲突的种子
+#define DRV_SEED_TRIES (1024)						  // 查找无冲突种子的最大尝试次数
+
+#if VIRTUALOS_DYNAMIC_DEVICE
+static struct robin_hash driver_table = { 0 };
+#endif
+
+// 静态设备的可变状态
+struct drv_static_device {
+	struct drv_device dev;
+	struct drv_file file;
+	char name[VIRTUALOS_MAX_DEV_NAME_LEN]; // 与动态设备一样截断到 VIRTUALOS_MAX_DEV_NAME_LEN
+};
+
+static struct drv_static_device static_dev[VIRTUALOS_MAX_DEV_NUM];
+static size_t static_num = 0;
+static uint8_t static_slot[DRV_STATIC_SLOTS]; // 槽位对应的静态设备序号加1 0表示空槽位
+static uint8_t static_order[VIRTUALOS_MAX_DEV_NUM]; // 按设备名排序的静态设备序号 找不到无冲突的种子时二分查找
+static uint32_t static_seed = 0;
+static bool static_perfect = false; // 找到无冲突的种子 否则二分查找
+
+/**
+ * @brief 带种子的 FNV-1a 哈希
+ * 
+ * @param name 设备名
+ * @param seed 种子
+ * @return uint32_t 槽位
+ */
+static uint32_t static_hash(const char *name, uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ seed;
+
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619;
+	}
+
+	return hash % DRV_STATIC_SLOTS;
+}
+
+/**
+ * @brief 为静态设备建立完美哈希表 依次尝试种子, 直到所有设备名落在不同的槽位
+ * 
+ * 最多计算 DRV_SEED_TRIES * 静态设备数 次哈希, 找不到时查找退化为二分查找
+ * 
+ * @return bool 找到返回true
+ */
+static bool static_build_table(void)
+{
+	for (uint32_t seed = 0; seed < DRV_SEED_TRIES; seed++) {
+		memset(static_slot, 0, sizeof(static_slot));
+
+		size_t i;
+		for (i = 0; i < static_num; i++) {
+			uint32_t slot = static_hash(static_dev[i].name, seed);
+			if (static_slot[slot])
+				break;
+			static_slot[slot] = i + 1;
+		}
+
+		if (i == static_num) {
+			static_seed = seed;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief 在按名称排序的静态设备中二分查找
+ * 
+ * @param name 设备名
+ * @param pos 输出设备名在 static_order 中的位置 不存在时为应插入的位置
+ * @return bool 存在返回true
+ */
+static bool static_search(const char *name, size_t *pos)
+{
+	size_t lo = 0, hi = static_num;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		int cmp = strcmp(static_dev[static_order[mid]].name, name);
+
+		if (!cmp) {
+			*pos = mid;
+			return true;
+		}
+
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*pos = lo;
+	return false;
+}
+
+/**
+ * @brief 查找静态设备
+ * 
+ * 找到无冲突的种子时为一次哈希与一次字符串比较, 否则为 log2(静态设备数) 次字符串比较
+ * 
+ * @param name 设备名
+ * @return struct drv_device* 设备结构体 不存在时返回NULL
+ */
+static struct drv_device *find_static_device(const char *name)
+{
+	size_t pos;
+
+	if (!static_num)
+		return NULL;
+
+	if (likely(static_perfect)) {
+		uint8_t idx = static_slot[static_hash(name, static_seed)];
+		if (idx && strcmp(static_dev[idx - 1].name, name) == 0)
+			return &static_dev[idx - 1].dev;
+		return NULL;
+	}
+
+	return static_search(name, &pos) ? &static_dev[static_order[pos]].dev : NULL;
+}
+
+/**
+ * @brief 追加一个设备名到缓冲区 以换行符`\r\n`结尾
+ * 
+ * @param buf 缓冲区 追加后后移
+ * @param len 剩余长度 追加后减少
+ * @param name 设备名
+ * @return bool 空间不足返回false
+ */
+static bool append_device_name(char **buf, size_t *len, const char *name)
+{
+	size_t name_len = strlen(name);
+	if (name_len + 2 > *len)
+		return false;
+
+	memcpy(*buf, name, name_len);
+	*buf += name_len;
+	*(*buf)++ = '\r';
+	*(*buf)++ = '\n';
+	*len -= name_len + 2;
+
+	return true;
+}
 
 /**
  * @brief 初始化驱动管理
@@ -47,7 +192,55 @@ static struct hash_table driver_table = { 0 };
  */
 void driver_manage_init(void)
 {
-	virtual_os_assert(init_hash_table(&driver_table, VIRTUALOS_MAX_DEV_NUM) == HASH_SUCCESS);
+#if VIRTUALOS_DYNAMIC_DEVICE
+	virtual_os_assert(robin_hash_init(&driver_table, VIRTUALOS_MAX_DEV_NUM) == HASH_SUCCESS);
+#endif
+}
+
+/**
+ * @brief 注册静态设备
+ * 
+ * @param desc 描述符数组
+ * @param num 描述符数量
+ */
+void driver_register_static(const struct drv_device_desc *desc, size_t num)
+{
+	if (!desc)
+		return;
+
+	static_perfect = false; // 建表之前二分查找, 用于重名检查
+
+	for (size_t i = 0; i < num && static_num < VIRTUALOS_MAX_DEV_NUM; i++) {
+		size_t pos;
+
+		if (!desc[i].name || !desc[i].opts)
+			continue;
+
+		struct drv_static_device *sdev = &static_dev[static_num];
+		memset(sdev, 0, sizeof(struct drv_static_device));
+		strncpy(sdev->name, desc[i].name, VIRTUALOS_MAX_DEV_NAME_LEN - 1);
+
+		// 截断后重名的设备同样只保留先注册的
+		if (static_search(sdev->name, &pos))
+			continue;
+
+		sdev->file.opts = desc[i].opts;
+		sdev->dev.file = &sdev->file;
+
+		if (desc[i].init && !desc[i].init(&sdev->dev))
+			continue;
+
+		memmove(&static_order[pos + 1], &static_order[pos], static_num - pos);
+		static_order[pos] = static_num;
+		++static_num;
+	}
+
+	static_perfect = static_build_table();
+}
+
+bool driver_static_hashed(void)
+{
+	return static_perfect;
 }
 
 /**
@@ -61,8 +254,21 @@ void driver_manage_init(void)
  */
 bool driver_register(driver_init drv_init, const struct file_operations *file_opts, const char *name)
 {
+#if VIRTUALOS_DYNAMIC_DEVICE
 	enum hash_error err = HASH_POINT_ERROR;
 
+	if (!name)
+		return false;
+
+	// 表中保存键的副本, 截断后的设备名放在栈上即可
+	char new_name[VIRTUALOS_MAX_DEV_NAME_LEN];
+	strncpy(new_name, name, VIRTUALOS_MAX_DEV_NAME_LEN - 1);
+	new_name[VIRTUALOS_MAX_DEV_NAME_LEN - 1] = '\0';
+
+	// 查找时静态设备优先, 同名的动态设备永远不会被找到
+	if (find_static_device(new_name))
+		return false;
+
 	struct drv_device *dev = calloc(1, sizeof(struct drv_device));
 	if (!dev)
 		return false;
@@ -76,24 +282,12 @@ bool driver_register(driver_init drv_init, const struct file_operations *file_op
 	if (!drv_init(dev))
 		goto free_file;
 
-	char *new_name = (char *)name;
-	if (unlikely(strlen(name) >= VIRTUALOS_MAX_DEV_NAME_LEN - 1)) {
-		new_name = (char *)calloc(1, VIRTUALOS_MAX_DEV_NAME_LEN);
-		if (!new_name)
-			goto free_file;
-		strncpy(new_name, name, VIRTUALOS_MAX_DEV_NAME_LEN - 1);
-		new_name[VIRTUALOS_MAX_DEV_NAME_LEN - 1] = '\0';
-	}
-
-	err = hash_insert(&driver_table, (const char *)new_name, (void *)dev);
+	err = robin_hash_insert(&driver_table, new_name, (void *)dev);
 	if (err != HASH_SUCCESS)
-		goto free_name;
+		goto free_file;
 
 	return true;
 
-free_name:
-	free(new_name);
-
 free_file:
 	free(dev->file);
 
@@ -101,6 +295,9 @@ free_dev:
 	free(dev);
 
 	return false;
+#else
+	return false;
+#endif
 }
 
 /**
@@ -111,13 +308,21 @@ free_dev:
  */
 struct drv_device *find_device(const char *name)
 {
-	struct drv_device *dev = NULL;
+	if (!name)
+		return NULL;
+
+	struct drv_device *dev = find_static_device(name);
+	if (dev)
+		return dev;
+
+#if VIRTUALOS_DYNAMIC_DEVICE
 	enum hash_error err;
-	dev = (struct drv_device *)hash_find(&driver_table, name, &err);
+	dev = (struct drv_device *)robin_hash_find(&driver_table, name, &err);
 	if (err == HASH_SUCCESS)
 		return dev;
-	else
-		return NULL;
+#endif
+
+	return NULL;
 }
 
 /**
@@ -130,17 +335,15 @@ void visit_all_device_name(void (*visit)(const char *name))
 	if (!visit)
 		return;
 
-	enum hash_error err = HASH_KEY_NOT_FOUND;
-	char **keys = NULL;
-	size_t num_keys = 0;
-	err = hash_get_all_keys(&driver_table, &keys, &num_keys);
-	if (err == HASH_SUCCESS) {
-		for (size_t i = 0; i < num_keys; i++) {
-			visit(keys[i]);
-			free(keys[i]);
-		}
-		free(keys);
-	}
+	for (size_t i = 0; i < static_num; i++)
+		visit(static_dev[i].name);
+
+#if VIRTUALOS_DYNAMIC_DEVICE
+	size_t iter = 0;
+	const char *key;
+	while (robin_hash_next(&driver_table, &iter, &key, NULL))
+		visit(key);
+#endif
 }
 
 /**
@@ -154,27 +357,21 @@ void fill_all_device_name(char *buf, size_t len)
 	if (!buf || !len)
 		return;
 
-	enum hash_error err = HASH_KEY_NOT_FOUND;
-	char **keys = NULL;
-	size_t num_keys = 0;
-	err = hash_get_all_keys(&driver_table, &keys, &num_keys);
-	if (err == HASH_SUCCESS) {
-		for (size_t i = 0; i < num_keys; i++) {
-			size_t name_len = strlen(keys[i]);
-			if (name_len + 1 > len)
-				break;
-			memcpy(buf, keys[i], name_len);
-			buf += name_len;
-			*buf++ = '\r';
-			*buf++ = '\n';
-			len -= name_len + 2;
-		}
-		if (len > 0)
-			*buf = '\0';
-		for (size_t i = 0; i < num_keys; i++)
-			free(keys[i]);
-		free(keys);
-	}
+	char *pos = buf;
+	bool full = false;
+
+	for (size_t i = 0; i < static_num && !full; i++)
+		full = !append_device_name(&pos, &len, static_dev[i].name);
+
+#if VIRTUALOS_DYNAMIC_DEVICE
+	size_t iter = 0;
+	const char *key;
+	while (!full && robin_hash_next(&driver_table, &iter, &key, NULL))
+		full = !append_device_name(&pos, &len, key);
+#endif
+
+	if (len > 0)
+		*pos = '\0';
 }
 
 /**
@@ -34,9 +34,11 @@
 
 #if VIRTUALOS_SHELL_ENABLE // 使能此宏
 
+#include <stdio.h>
 #include <string.h>
 
 #include "utils/simple_shell.h"
+#include "utils/stimer.h"
 
 #include "driver/virtual_os_driver.h"
 
@@ -79,6 +81,50 @@ static void show_device(int argc, char *argv[], uint8_t *out, size_t buf_size, s
 }
 SPS_EXPORT_CMD(show_device, show_device, "list all devices")
 
+#if STIMER_ENABLE_PROFILE
+/* ====================== 框架内置命令: top ====================== */
+static void top(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	// 列出上次执行 top 以来每个任务的执行时间与释放延迟(us), 以及主循环与快速任务(F)的负载
+
+	*out_len = 0;
+	if (argc != 1)
+		return;
+
+	char *buf = (char *)out;
+	size_t len = 0;
+	int n;
+	struct stimer_load load;
+	struct stimer_task_prof prof;
+	stimer_handle task = NULL;
+
+	stimer_get_load(&load);
+	n = snprintf(buf, buf_size,
+		"load %u.%u%% busy %luus idle %luus fast %u.%u%% %luus\r\n%-12s %1s %8s %6s %6s %6s %6s %6s\r\n",
+		load.usage / 10, load.usage % 10, (unsigned long)load.busy_us, (unsigned long)load.idle_us,
+		load.fast_usage / 10, load.fast_usage % 10, (unsigned long)load.fast_us, "name", "T", "count", "min", "avg",
+		"max", "lat", "latmax");
+	if (n < 0 || (size_t)n >= buf_size)
+		return;
+	len = n;
+
+	while ((task = stimer_task_next(task)) != NULL) {
+		stimer_task_get_prof(task, &prof);
+		n = snprintf(buf + len, buf_size - len, "%-12.12s %1s %8lu %6lu %6lu %6lu %6lu %6lu\r\n", stimer_task_name(task),
+			stimer_task_get_tier(task) == STIMER_TIER_FAST ? "F" : "", (unsigned long)prof.count,
+			(unsigned long)prof.exec_min, (unsigned long)prof.exec_avg, (unsigned long)prof.exec_max,
+			(unsigned long)prof.latency_avg, (unsigned long)prof.latency_max);
+		if (n < 0 || (size_t)n >= buf_size - len)
+			break;
+		len += n;
+	}
+
+	*out_len = len;
+	stimer_prof_reset();
+}
+SPS_EXPORT_CMD(top, top, "show task execution time and scheduler load")
+#endif /* STIMER_ENABLE_PROFILE */
+
 /************************************EXPOSE API************************************/
 
 /**
@@ -44,6 +44,18 @@
 // 设备数量配置
 #define VIRTUALOS_MAX_DEV_NUM (10)		/* 最大设备数量 同时用于驱动数量以及文件描述符的数量 */
 #define VIRTUALOS_MAX_DEV_NAME_LEN (16) /* 最大设备名长度(包括\0) */
+#define VIRTUALOS_DYNAMIC_DEVICE (1)	/* 支持 driver_register 动态注册 0:只支持 EXPORT_DEVICE 静态设备, 初始化不使用堆 */
+
+// DAL块缓存配置 存储设备通过`dal_cache_enable`启用, 参考`dal/dal_opt.h` 可以在编译选项中定义以覆盖默认值
+#ifndef VIRTUALOS_DAL_CACHE_PAGES
+#define VIRTUALOS_DAL_CACHE_PAGES (4) /* 缓存页数量 所有启用缓存的文件共用 0:不编译缓存 */
+#endif
+#ifndef VIRTUALOS_DAL_CACHE_PAGE_SIZE
+#define VIRTUALOS_DAL_CACHE_PAGE_SIZE (32) /* 最大缓存页大小(字节) 占用内存约为 页数量 * 页大小 */
+#endif
+#ifndef VIRTUALOS_DAL_CACHE_READ_AHEAD
+#define VIRTUALOS_DAL_CACHE_READ_AHEAD (1) /* 顺序读取未命中时额外预读的页数 0:不预读 */
+#endif
 
 // Shell使能配置
 // 注: 如果框架使用静态库编译则不建议使用此功能，因为Shell与具体的芯片平台串口有强依赖关系，不适用于静态库链接
@@ -34,6 +34,8 @@
 #define __VIRTUAL_OS_DAL_OPT_H__
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #define RESERVED_FDS (3) /* 前三个文件描述符为内部保留值 */
 
@@ -44,6 +46,7 @@
 #define DAL_ERR_EXCEPTION (-4)	 /* 操作异常，例如对只读设备进行写操作,空指针等 */
 #define DAL_ERR_OCCUPIED (-5)	 /* 设备被占用 */
 #define DAL_ERR_NOT_EXIST (-6)	 /* 设备不存在 */
+#define DAL_ERR_NOT_SUPPORT (-7) /* 设备不支持该操作 */
 
 /**
  * @brief 打开文件
@@ -107,4 +110,347 @@ enum dal_lseek_whence {
  */
 int dal_lseek(int fd, int offset, enum dal_lseek_whence whence);
 
+/****************************VECTORED API*****************************/
+
+#define DAL_IOV_MAX (16) /* 一次分散/聚集读写的最大段数 */
+
+/**
+ * @brief 分散/聚集读写的一段缓冲区
+ */
+struct dal_iovec {
+	void *base; /* 缓冲区 */
+	size_t len; /* 大小 */
+};
+
+/**
+ * @brief 依次读取到多段缓冲区，读取成功后将增加文件偏移量
+ * 
+ * 驱动实现了 readv 时一次交给驱动(例如配置DMA链表), 否则逐段调用 read, 某一段未读满时停止
+ * 
+ * @param fd 文件描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 段数 不超过 DAL_IOV_MAX
+ * @return size_t 返回实际读取字节数
+ */
+size_t dal_readv(int fd, const struct dal_iovec *iov, int iovcnt);
+
+/**
+ * @brief 依次写入多段缓冲区，写入成功后将增加文件偏移量
+ * 
+ * 例如帧头、数据、校验分别存放时无需拷贝到同一个缓冲区, 也不必多次调用 dal_write
+ * 
+ * @param fd 文件描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 段数 不超过 DAL_IOV_MAX
+ * @return size_t 返回实际写入字节数
+ */
+size_t dal_writev(int fd, const struct dal_iovec *iov, int iovcnt);
+
+/**
+ * @brief 从指定偏移读取数据，不使用也不修改文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param buf 读缓冲区
+ * @param len 大小
+ * @param offset 文件偏移
+ * @return size_t 返回实际读取字节数
+ */
+size_t dal_pread(int fd, void *buf, size_t len, size_t offset);
+
+/**
+ * @brief 向指定偏移写入数据，不使用也不修改文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param buf 写缓冲区
+ * @param len 大小
+ * @param offset 文件偏移
+ * @return size_t 返回实际写入字节数
+ */
+size_t dal_pwrite(int fd, void *buf, size_t len, size_t offset);
+
+/****************************ZERO-COPY API*****************************/
+
+/**
+ * 零拷贝读写, 需要驱动实现 read_acquire/read_release 或 write_reserve/write_commit:
+ * 
+ * 1. 借出的是驱动缓冲区中可连续访问的区域, 数据跨越驱动缓冲区末尾时分两次借出
+ * 2. 借出后必须归还或提交(长度可以为0)才能再次借出, 借出期间 dal_close 返回 DAL_ERR_OCCUPIED
+ * 3. 归还或提交的长度不超过借出的长度, 超出部分被忽略
+ */
+
+#define DAL_SPLICE_CHUNK (64) /* dal_splice 两端都不支持零拷贝时使用的中转缓冲区大小 */
+
+/**
+ * @brief 借出驱动中可读取的数据 不拷贝到用户缓冲区
+ * 
+ * @param fd 文件描述符
+ * @param buf 返回数据地址
+ * @param len 传入期望的最大字节数, 返回借出的字节数 没有数据时为0
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_read_acquire(int fd, void **buf, size_t *len);
+
+/**
+ * @brief 归还借出的数据 并从驱动中移除已处理的部分
+ * 
+ * @param fd 文件描述符
+ * @param len 已处理的字节数 未处理的部分下次仍可读取
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_read_release(int fd, size_t len);
+
+/**
+ * @brief 借出驱动中可写入的空间 应用直接在其中填充数据
+ * 
+ * @param fd 文件描述符
+ * @param buf 返回空间地址
+ * @param len 传入期望的最大字节数, 返回借出的字节数 没有空间时为0
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_write_reserve(int fd, void **buf, size_t *len);
+
+/**
+ * @brief 提交已写入借出空间的数据
+ * 
+ * @param fd 文件描述符
+ * @param len 已写入的字节数
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_write_commit(int fd, size_t len);
+
+/**
+ * @brief 在两个设备之间搬运数据 例如CAN转串口 不经过用户缓冲区
+ * 
+ * 输入设备支持借出时直接把借出的数据写入输出设备, 只移除已写入的部分; 否则输出设备支持借出时直接读取到借出的空间;
+ * 两端都不支持时, 只有输出为存储设备(设置了 dev_size)才经过 DAL_SPLICE_CHUNK 大小的中转缓冲区,
+ * 每次读取不超过输出设备的剩余空间; 输出为流设备时无法保证读出的数据都能写入, 返回 DAL_ERR_NOT_SUPPORT
+ * 任一设备有未完成的异步请求(dal_submit_read 等)时返回 DAL_ERR_OCCUPIED
+ * 输出设备已满时停止搬运, 已读取的数据不会丢失
+ * 
+ * @param fd_in 输入文件描述符
+ * @param fd_out 输出文件描述符
+ * @param len 最多搬运的字节数
+ * @return size_t 返回实际搬运的字节数 失败参考错误码
+ */
+size_t dal_splice(int fd_in, int fd_out, size_t len);
+
+/****************************POLL API*****************************/
+
+/**
+ * 就绪查询, 一次检查多个文件是否可读写, 代替逐个调用 dal_read 试探:
+ * 
+ * 1. 驱动实现 poll 时返回当前的就绪事件, 未实现时视为一直可读写
+ * 2. 在任务中调用且 timeout_ms 不为0时, 没有文件就绪则登记当前任务, 驱动调用 dal_poll_notify 时唤醒任务,
+ *    适合事件任务(周期为0): 只在有数据或超时时执行
+ * 3. 调度器是协作式的, dal_poll 从不阻塞, 唤醒后任务需要再次调用 dal_poll 获取就绪事件
+ * 4. 每次登记只唤醒一次, 任务被唤醒(就绪或超时)或查询到就绪后, 本次登记的所有文件同时失效
+ * 5. 一个文件同一时间只能由一个任务等待, 其他任务已在等待时返回 DAL_ERR_OCCUPIED;
+ *    同时等待的任务数见 DAL_POLL_MAX_WAITER, 超出时同样返回 DAL_ERR_OCCUPIED
+ */
+
+#define DAL_POLLIN (1 << 0)	 /* 可读 */
+#define DAL_POLLOUT (1 << 1) /* 可写 */
+#define DAL_POLLERR (1 << 2) /* 错误 总是报告 文件描述符无效时也报告此事件 */
+
+#define DAL_POLL_FOREVER (-1)	/* 只等待就绪通知 不超时 */
+#define DAL_POLL_MAX_WAITER (4)	/* 同时登记等待的任务数 */
+
+/**
+ * @brief 查询的文件与事件
+ */
+struct dal_pollfd {
+	int fd;			  /* 文件描述符 */
+	uint16_t events;  /* 关注的事件 */
+	uint16_t revents; /* 就绪的事件 由 dal_poll 填充 */
+};
+
+/**
+ * @brief 查询多个文件的就绪事件
+ * 
+ * @param pfds 查询数组
+ * @param n 数量
+ * @param timeout_ms 0 只查询; DAL_POLL_FOREVER 没有就绪时登记当前任务等待唤醒;
+ *                   大于0时还会在超时后唤醒, 软件定时器用完时只等待就绪通知
+ * @return int 就绪的文件数 失败参考错误码
+ */
+int dal_poll(struct dal_pollfd *pfds, size_t n, int timeout_ms);
+
+struct drv_file;
+
+/**
+ * @brief 驱动的就绪状态变化时调用 唤醒等待该文件的任务 可在中断中调用
+ * 
+ * @param file 驱动文件
+ * @param events 新就绪的事件
+ */
+void dal_poll_notify(struct drv_file *file, uint16_t events);
+
+/****************************CACHE API*****************************/
+
+/**
+ * 块缓存, 用于EEPROM等存储设备(驱动设置了 dev_size), 减少总线传输次数:
+ * 
+ * 1. 按页缓存, 页大小通常等于器件的页写大小, 缓存页由所有启用缓存的设备共用, 数量见 VIRTUALOS_DAL_CACHE_PAGES;
+ *    缓存页按设备查找, 同一设备打开多次时所有文件共用缓存与页大小, 任一文件启用或关闭缓存对所有文件生效
+ * 2. 写回: 写入只修改缓存, 同一页内相邻或重叠的多次写入合并为一次驱动写入, 在页被淘汰、dal_sync 或 dal_close 时写回
+ * 3. 预读: 顺序读取未命中时额外读取之后的 VIRTUALOS_DAL_CACHE_READ_AHEAD 页, 驱动实现了 readv 时只需一次驱动读取
+ * 4. 经过缓存的接口: dal_read/dal_write/dal_pread/dal_pwrite/dal_readv/dal_writev;
+ *    异步读写与 dal_splice 直接访问设备, 提交前自动写回并丢弃该设备的缓存
+ * 5. 掉电前未写回的数据会丢失, 保存参数后应调用 dal_sync
+ * 6. 淘汰的页写回失败时改为淘汰干净页, 没有可淘汰的页时不经过缓存直接读写设备
+ */
+
+/**
+ * @brief 缓存统计 命中与未命中按页计数
+ */
+struct dal_cache_stat {
+	uint32_t read_hits;	   /* 读取命中 */
+	uint32_t read_misses;  /* 读取未命中 */
+	uint32_t write_hits;   /* 写入已缓存的页 */
+	uint32_t write_misses; /* 写入未缓存的页 */
+	uint32_t bus_reads;	   /* 驱动读取次数 */
+	uint32_t bus_writes;   /* 驱动写入次数 */
+	uint32_t evictions;	   /* 淘汰的页数 */
+};
+
+/**
+ * @brief 为文件启用块缓存
+ * 
+ * @param fd 文件描述符
+ * @param page_size 页大小 不超过 VIRTUALOS_DAL_CACHE_PAGE_SIZE, 为0时写回并关闭缓存
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码 不是存储设备或未编译缓存时返回DAL_ERR_EXCEPTION
+ */
+int dal_cache_enable(int fd, size_t page_size);
+
+/**
+ * @brief 把文件所在设备的脏页写回设备
+ * 
+ * @param fd 文件描述符
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_sync(int fd);
+
+/**
+ * @brief 获取缓存统计 所有文件合计
+ * 
+ * @param stat 统计结果
+ */
+void dal_cache_get_stat(struct dal_cache_stat *stat);
+
+/**
+ * @brief 清零缓存统计
+ */
+void dal_cache_reset_stat(void);
+
+/****************************ASYNC API*****************************/
+
+/**
+ * 异步读写, 提交请求后立即返回, 调用者所在的任务不会被慢速设备阻塞:
+ * 
+ * 1. 请求结构体由调用者分配, 完成之前不能释放或复用, 同一设备可以同时有多个未完成的请求, 按提交顺序处理
+ * 2. 读写请求在提交时确定文件偏移并增加设备的文件偏移, 连续提交的请求依次读写相邻的区域
+ * 3. 驱动实现了 submit 时由驱动启动操作, 操作完成后驱动(可在中断中)调用 dal_aio_complete
+ * 4. 驱动未实现 submit 时由工作任务调用同步的 read/write/ioctl 完成, 每次执行只处理一个这样的请求,
+ *    调用者不再等待, 但同步驱动执行期间主循环仍被占用
+ * 5. 完成回调在工作任务中(主循环)调用, 也可以不设置回调, 用 dal_aio_done 查询
+ * 6. 关闭文件之前需要等待该文件的所有请求完成, 否则 dal_close 返回 DAL_ERR_OCCUPIED
+ * 7. 启用了块缓存的文件, 提交读写请求时写回并丢弃缓存; 请求完成之前同一设备的同步读写(包括 dal_cache_enable)
+ *    返回 DAL_ERR_OCCUPIED, 避免缓存从设备读到异步写入之前的数据
+ * 8. 工作任务由 dal_init 创建, dal_init 需要在 stimer_init 之后调用, 之前提交请求返回 DAL_ERR_EXCEPTION
+ */
+
+#define DAL_AIO_POLL_MS (10) /* 工作任务的兜底周期 正常情况下由提交与完成唤醒 */
+
+enum dal_aio_op {
+	DAL_AIO_READ,  /* 读取 */
+	DAL_AIO_WRITE, /* 写入 */
+	DAL_AIO_IOCTL, /* 控制命令 */
+};
+
+enum dal_aio_state {
+	DAL_AIO_IDLE,	 /* 未提交或已取回结果 */
+	DAL_AIO_QUEUED,	 /* 等待驱动处理 */
+	DAL_AIO_RUNNING, /* 驱动正在处理 */
+	DAL_AIO_DONE,	 /* 已完成 等待调用回调 */
+};
+
+struct dal_aio_req;
+
+/**
+ * @brief 完成回调
+ * 
+ * @param req 请求 回调中可以复用请求再次提交
+ */
+typedef void (*dal_aio_cb)(struct dal_aio_req *req);
+
+/**
+ * @brief 异步请求 由调用者分配, 通过 dal_submit_xxx 填充
+ */
+struct dal_aio_req {
+	int fd;					  /* 文件描述符 */
+	enum dal_aio_op op;		  /* 操作 */
+	void *buf;				  /* 读写缓冲区 */
+	size_t len;				  /* 读写长度 */
+	size_t offset;			  /* 读写的文件偏移 提交时确定 */
+	int cmd;				  /* 控制命令 */
+	void *arg;				  /* 控制命令的参数 */
+	dal_aio_cb done_f;		  /* 完成回调 可为NULL */
+	void *user;				  /* 用户数据 */
+	int result;				  /* 结果 读写为实际字节数, 控制命令为返回值, 负数为错误码 */
+	enum dal_aio_state state; /* 状态 */
+	struct dal_aio_req *next; /* 队列链接 内部使用 */
+};
+
+/**
+ * @brief 提交异步读取
+ * 
+ * @param req 请求
+ * @param fd 文件描述符
+ * @param buf 读缓冲区 完成之前保持有效
+ * @param len 大小
+ * @param done_f 完成回调 可为NULL
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_submit_read(struct dal_aio_req *req, int fd, void *buf, size_t len, dal_aio_cb done_f);
+
+/**
+ * @brief 提交异步写入
+ * 
+ * @param req 请求
+ * @param fd 文件描述符
+ * @param buf 写缓冲区 完成之前保持有效
+ * @param len 大小
+ * @param done_f 完成回调 可为NULL
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_submit_write(struct dal_aio_req *req, int fd, void *buf, size_t len, dal_aio_cb done_f);
+
+/**
+ * @brief 提交异步控制命令
+ * 
+ * @param req 请求
+ * @param fd 文件描述符
+ * @param cmd 操作命令
+ * @param arg 参数 完成之前保持有效
+ * @param done_f 完成回调 可为NULL
+ * @return int 成功返回DAL_ERR_NONE 失败参考错误码
+ */
+int dal_submit_ioctl(struct dal_aio_req *req, int fd, int cmd, void *arg, dal_aio_cb done_f);
+
+/**
+ * @brief 请求是否已完成 完成后 result 有效
+ * 
+ * @param req 请求
+ * @return bool 已完成或未提交返回true
+ */
+bool dal_aio_done(struct dal_aio_req *req);
+
+/**
+ * @brief 驱动完成异步请求时调用 可在中断中调用
+ * 
+ * @param req 请求
+ * @param result 结果 读写为实际字节数, 控制命令为返回值, 负数为错误码
+ */
+void dal_aio_complete(struct dal_aio_req *req, int result);
+
 #endif /* __VIRTUAL_OS_DAL_OPT_H__ */
@@ -44,6 +44,7 @@
 #define DRV_ERR_EXCEPTION (-4)	 /* 操作异常，例如对只读设备进行写操作,空指针等 */
 #define DRV_ERR_OCCUPIED (-5)	 /* 设备被占用 */
 #define DRV_ERR_NOT_EXIST (-6)	 /* 设备不存在 */
+#define DRV_ERR_NOT_SUPPORT (-7) /* 设备不支持该操作 */
 
 /**
  * @brief 初始化驱动管理
@@ -75,11 +76,27 @@ struct drv_device {
 
 /****************************USER API*****************************/
 
+struct dal_aio_req;
+struct dal_iovec;
+
 /**
  * @brief 文件操作接口 一一对应于应用层的`dal/dal_opts.h`中的接口
  * 
  * 所有对外设的读写控制等都通过此接口进行，在调用初始化`driver_register`的时候会注册进驱动中
  * 
+ * readv/writev 用于分散/聚集读写: 能一次处理多段缓冲区的驱动(例如DMA链表)可以实现, 返回实际读写的总字节数;
+ * 未实现时DAL逐段调用 read/write
+ * 
+ * read_acquire/read_release 与 write_reserve/write_commit 用于零拷贝读写(通常是流式设备):
+ * 驱动把自己的缓冲区(例如接收队列)中可连续访问的区域借给应用, 应用处理完后归还或提交实际使用的字节数;
+ * len 传入时为期望的最大字节数, 返回时为借出的字节数, 没有数据或空间时为0
+ * 
+ * poll 返回当前的就绪事件(DAL_POLLIN/DAL_POLLOUT/DAL_POLLERR), 应只检查状态而不读写数据;
+ * 就绪状态变化时(例如接收中断)调用`dal_poll_notify`唤醒等待的任务
+ * 
+ * submit 用于异步操作: 驱动启动请求后立即返回DRV_ERR_NONE, 操作完成后(可在中断中)调用`dal_aio_complete`;
+ * 设备忙时返回DRV_ERR_OCCUPIED, 请求留在队列中稍后重试; 未实现时异步请求由DAL的工作任务调用 read/write/ioctl 完成
+ * 
  */
 struct file_operations {
 	int (*open)(struct drv_file *file);						 /* 打开设备 返回结果参考错误码 */
@@ -87,6 +104,14 @@ struct file_operations {
 	int (*ioctl)(struct drv_file *file, int cmd, void *arg); /* 控制命令 返回结果参考错误码 */
 	size_t (*read)(struct drv_file *file, void *buf, size_t len, size_t *offset);  /* 读取数据 */
 	size_t (*write)(struct drv_file *file, void *buf, size_t len, size_t *offset); /* 写入数据 */
+	int (*submit)(struct drv_file *file, struct dal_aio_req *req);				   /* 异步操作 可为NULL 参考`dal/dal_opt.h` */
+	size_t (*readv)(struct drv_file *file, const struct dal_iovec *iov, int iovcnt, size_t *offset);  /* 分散读取 可为NULL */
+	size_t (*writev)(struct drv_file *file, const struct dal_iovec *iov, int iovcnt, size_t *offset); /* 聚集写入 可为NULL */
+	int (*read_acquire)(struct drv_file *file, void **buf, size_t *len);  /* 借出可读取的数据 可为NULL */
+	int (*read_release)(struct drv_file *file, size_t len);				  /* 归还并移除已读取的数据 */
+	int (*write_reserve)(struct drv_file *file, void **buf, size_t *len); /* 借出可写入的空间 可为NULL */
+	int (*write_commit)(struct drv_file *file, size_t len);				  /* 提交已写入的数据 */
+	int (*poll)(struct drv_file *file);									  /* 就绪查询 可为NULL */
 };
 
 /**
@@ -110,11 +135,63 @@ struct file_operations {
  */
 typedef bool (*driver_init)(struct drv_device *dev);
 
+/**
+ * @brief 静态设备描述符 由 EXPORT_DEVICE 生成, 存放在 .early_device 段中
+ */
+struct drv_device_desc {
+	const char *name;					/* 设备名称 */
+	driver_init init;					/* 驱动初始化 可为NULL */
+	const struct file_operations *opts; /* 驱动文件操作 */
+};
+
+/**
+ * @brief 静态设备注册宏
+ * 
+ * 例如: EXPORT_DEVICE("uart1", uart_driver_init, &uart_opts);
+ * 描述符集中存放在 .early_device 段(FLASH), 设备与文件结构体来自预分配的数组, 不使用堆内存
+ * virtual_os_init 依次调用各设备的初始化函数, 并为初始化成功的设备建立完美哈希表, 查找设备只需一次哈希与一次比较
+ * 设备名与 driver_register 一样截断到 VIRTUALOS_MAX_DEV_NAME_LEN, 截断后重名时只保留先注册的设备
+ * 多个设备可以共用同一个初始化函数, 初始化函数也可以为NULL
+ * 
+ */
+#define EXPORT_DEVICE(_name, _init, _opts) _EXPORT_DEVICE(_name, _init, _opts, __COUNTER__)
+
+/* 描述符的符号名由 __COUNTER__ 生成, 需要两层展开 */
+#define _EXPORT_DEVICE(_name, _init, _opts, _id) __EXPORT_DEVICE(_name, _init, _opts, _id)
+#define __EXPORT_DEVICE(_name, _init, _opts, _id)                                                                      \
+	static const struct drv_device_desc _drv_dev_desc_##_id                                                            \
+		__attribute__((section(".early_device"), used, aligned(sizeof(void *)))) = {                                   \
+			.name = _name,                                                                                             \
+			.init = _init,                                                                                             \
+			.opts = _opts,                                                                                             \
+		}
+
+/**
+ * @brief 注册静态设备 由 virtual_os_init 调用
+ * 
+ * @param desc 描述符数组
+ * @param num 描述符数量 超过 VIRTUALOS_MAX_DEV_NUM 的部分被忽略
+ */
+void driver_register_static(const struct drv_device_desc *desc, size_t num);
+
+/**
+ * @brief 静态设备是否建立了完美哈希表
+ * 
+ * 找不到无冲突的种子时查找退化为二分查找, 可以在初始化后检查, 通过增大 VIRTUALOS_MAX_DEV_NUM 或修改设备名解决
+ * 
+ * @return true 查找为一次哈希与一次字符串比较
+ * @return false 查找为二分查找
+ */
+bool driver_static_hashed(void);
+
 /**
  * @brief 注册设备
  * 
  * @param drv_init 驱动初始化
  * @param file_opts 驱动文件操作
+ * VIRTUALOS_DYNAMIC_DEVICE 为0时不支持动态注册, 返回false
+ * 设备名截断到 VIRTUALOS_MAX_DEV_NAME_LEN, 与已注册的静态设备重名时返回false
+ * 
  * @param name 设备名称
  * @return true 
  * @return false 
@@ -67,7 +67,7 @@ typedef struct mb_mst *mb_mst_handle;
  * @brief 主机初始化并申请句柄
  *
  * @param opts 读写等回调函数指针
- * @param period_ms 轮训周期
+ * @param period_ms 轮训周期 仅为兼容保留, 超时按调度器时钟(stimer_now_ms)计算
  * @return mb_mst_handle 成功返回句柄，失败返回NULL
  */
 mb_mst_handle mb_mst_init(struct serial_opts *opts, size_t period_ms);
@@ -81,4 +81,20 @@ list_item *list_delete_tail(list_item *head);
  */
 uint8_t list_add_tail(list_item *head, list_item *item);
 
+/**
+ * @brief 将 list 中的所有节点移动到 head 尾部, 并将 list 重新初始化为空链表
+ * 
+ * @param head 
+ * @param list 
+ */
+void list_splice_tail_init(list_item *head, list_item *list);
+
+/**
+ * @brief 判断链表是否为空
+ * 
+ * @param head 
+ * @return uint8_t 空链表返回1
+ */
+uint8_t list_is_empty(list_item *head);
+
 #endif /* __VIRTUAL_OS_LIST_H__ */
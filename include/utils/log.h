@@ -38,6 +38,7 @@
 #include <stdbool.h>
 
 #define USE_TIME_STAMP 0 /* 日志启用时显示时间,0为关闭,1为启用 开启会编译time.h头文件，将占用大量FLASH空间 */
+#define USE_UPTIME_STAMP 0 /* 日志显示上电后的时间(秒.毫秒),0为关闭,1为启用 不依赖time.h */
 #define MAX_LOG_LENGTH 256									 /* 每条日志的最大长度 */
 #define TOTAL_FRAME_COUNT (8)								 // 缓冲8条
 #define LOG_BUFFER_SIZE (MAX_LOG_LENGTH * TOTAL_FRAME_COUNT) /* 日志缓冲区总大小 2K */
@@ -67,8 +68,10 @@ struct log_interface {
 /**
  * @brief 日志初始化
  * 
+ * 时间戳由调度器的时钟(stimer_now_us)提供, 与日志任务的周期和执行时机无关
+ * 
  * @param interface 串口接口
- * @param period_ms 任务周期（毫秒）
+ * @param period_ms 任务周期（毫秒） 仅为兼容保留
  */
 void syslog_init(struct log_interface *interface, uint32_t period_ms);
 
@@ -0,0 +1,193 @@
+/**
+ * @file mailbox.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 核间邮箱
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_MAILBOX_H__
+#define __VIRTUAL_OS_MAILBOX_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * 核间邮箱, 用于运行在不同核(或不同线程)上的两个调度器实例之间传递定长消息:
+ * 
+ * 1. 单生产者单消费者的无锁环形缓冲, 发送端与接收端各自只写自己的索引, 用获取/释放语义的原子操作同步
+ * 2. 两端的索引分别位于独立的缓存行, 并各自缓存对端索引, 只在看起来满/空时才读取对端索引, 减少缓存行在核间来回迁移
+ * 3. 发送后邮箱由空变为非空时调用门铃函数(例如触发核间中断), 接收端在中断中投递处理任务, 批量发送只响铃一次
+ * 4. 零拷贝: 消息可以只是缓冲区的引用, 也可以用 mailbox_reserve/mailbox_commit 直接在环形缓冲中构造消息,
+ *    用 mailbox_peek/mailbox_release 直接在环形缓冲中处理消息
+ * 
+ * 邮箱结构体与缓冲区必须位于两个核都能访问且缓存一致的内存中(无数据缓存的核、共享SRAM或设置为不可缓存的区域),
+ * 消息中引用的缓冲区同样如此, 所有权随消息转移给接收端
+ * 
+ * 示例(核0发送, 核1接收):
+ * 
+ *	struct adc_msg {
+ *		uint16_t *samples; // 引用共享内存中的缓冲区
+ *		uint16_t num;
+ *	};
+ *
+ *	static struct mailbox mb SHARED_RAM;
+ *	static struct adc_msg mb_buf[16] SHARED_RAM;
+ *
+ *	static void ring_core1(void *arg) { IPC_TRIGGER(CORE1_IRQ); }
+ *
+ *	// 核0
+ *	mailbox_init(&mb, mb_buf, sizeof(struct adc_msg), 16);
+ *	mailbox_set_doorbell(&mb, ring_core1, NULL);
+ *	mailbox_post(&mb, &msg, 1);
+ *
+ *	// 核1 核间中断中唤醒事件任务
+ *	void CORE1_IRQHandler(void) { stimer_task_notify(mb_handle); }
+ *
+ *	static void mb_task(void)
+ *	{
+ *		struct adc_msg msg;
+ *		while (mailbox_fetch(&mb, &msg, 1))
+ *			process(msg.samples, msg.num);
+ *	}
+ */
+
+#ifndef MAILBOX_CACHE_LINE
+#define MAILBOX_CACHE_LINE (64) /* 缓存行大小(字节) Cortex-M7 为32 */
+#endif
+
+/**
+ * @brief 门铃函数 在发送端调用
+ * 
+ * @param arg 设置门铃时提供的参数
+ */
+typedef void (*mailbox_doorbell_f)(void *arg);
+
+/**
+ * @brief 邮箱结构体 由用户分配内存, 通过 mailbox_init 初始化
+ */
+struct mailbox {
+	/* 发送端 */
+	uint32_t wr __attribute__((aligned(MAILBOX_CACHE_LINE))); /* 写索引 */
+	uint32_t rd_cache;										  /* 发送端缓存的读索引 */
+	mailbox_doorbell_f doorbell;							  /* 门铃函数 可为NULL */
+	void *doorbell_arg;										  /* 门铃函数的参数 */
+
+	/* 接收端 */
+	uint32_t rd __attribute__((aligned(MAILBOX_CACHE_LINE))); /* 读索引 */
+	uint32_t wr_cache;										  /* 接收端缓存的写索引 */
+
+	/* 初始化后只读 */
+	uint8_t *buf __attribute__((aligned(MAILBOX_CACHE_LINE))); /* 缓冲区 */
+	uint32_t unit_bytes;									   /* 消息大小(字节数) */
+	uint32_t mask;											   /* 容量减1 */
+};
+
+/**
+ * @brief 初始化邮箱 由发送端或接收端在另一端开始使用之前调用一次
+ * 
+ * @param mb 邮箱
+ * @param buf 缓冲区
+ * @param unit_bytes 消息大小(字节数)
+ * @param units 缓冲区容量(消息数) 必须为2的幂
+ * @return bool 成功返回true，失败返回false
+ */
+bool mailbox_init(struct mailbox *mb, void *buf, size_t unit_bytes, size_t units);
+
+/**
+ * @brief 设置门铃函数 发送后邮箱由空变为非空时调用
+ * 
+ * @param mb 邮箱
+ * @param f 门铃函数 为NULL时不响铃
+ * @param arg 门铃函数的参数
+ */
+void mailbox_set_doorbell(struct mailbox *mb, mailbox_doorbell_f f, void *arg);
+
+/**
+ * @brief 发送消息 只能在发送端调用
+ * 
+ * @param mb 邮箱
+ * @param msg 消息
+ * @param num 消息数
+ * @return size_t 实际发送的消息数 空间不足时少于 num
+ */
+size_t mailbox_post(struct mailbox *mb, const void *msg, size_t num);
+
+/**
+ * @brief 在环形缓冲中预留一条消息的空间 只能在发送端调用
+ * 
+ * 构造完成后调用 mailbox_commit 发送, 在此之前接收端不可见
+ * 
+ * @param mb 邮箱
+ * @return void* 消息的空间 邮箱已满时返回NULL
+ */
+void *mailbox_reserve(struct mailbox *mb);
+
+/**
+ * @brief 发送 mailbox_reserve 预留的消息 只能在发送端调用
+ * 
+ * @param mb 邮箱
+ */
+void mailbox_commit(struct mailbox *mb);
+
+/**
+ * @brief 接收消息 只能在接收端调用
+ * 
+ * @param mb 邮箱
+ * @param msg 消息的缓冲区
+ * @param num 最多接收的消息数
+ * @return size_t 实际接收的消息数
+ */
+size_t mailbox_fetch(struct mailbox *mb, void *msg, size_t num);
+
+/**
+ * @brief 获取最早的一条消息 不移出邮箱 只能在接收端调用
+ * 
+ * 处理完成后调用 mailbox_release 归还空间, 在此之前发送端不会覆盖这条消息
+ * 
+ * @param mb 邮箱
+ * @return void* 消息 邮箱为空时返回NULL
+ */
+void *mailbox_peek(struct mailbox *mb);
+
+/**
+ * @brief 归还 mailbox_peek 获取的消息 只能在接收端调用
+ * 
+ * @param mb 邮箱
+ */
+void mailbox_release(struct mailbox *mb);
+
+/**
+ * @brief 获取邮箱中的消息数 在任意一端调用都只是某一时刻的快照
+ * 
+ * @param mb 邮箱
+ * @return size_t 消息数
+ */
+size_t mailbox_used(struct mailbox *mb);
+
+#endif /* __VIRTUAL_OS_MAILBOX_H__ */
@@ -0,0 +1,186 @@
+/**
+ * @file pipeline.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 基于调度组件的数据流水线
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_PIPELINE_H__
+#define __VIRTUAL_OS_PIPELINE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "utils/queue.h"
+
+/**
+ * 数据流水线, 相邻两级之间通过有界队列连接, 每一级都是一个事件任务:
+ * 
+ * 1. 一级只在输入队列有数据且输出队列有空间时执行, 产生输出后唤醒下一级, 不再需要周期轮询队列
+ * 2. 输出队列已满时该级停止处理并记为一次阻塞, 下一级取走数据后唤醒它, 阻塞由此逐级向上游传递,
+ *    最终到达第一级: 周期采样的源在输出队列已满时跳过本次采样, 由外部(例如中断)写入的输入队列写满后 queue_add 返回0
+ * 3. 单元在队列的缓冲区中就地处理, 级函数直接读取输入单元、写入输出单元, 不经过额外的复制
+ * 4. 每一级统计执行次数、输入输出单元数、阻塞次数与执行时间
+ * 
+ * 级函数每次处理一个输入单元(源没有输入), 通过返回值说明消耗了输入还是产生了输出, 两者都没有时本次执行结束:
+ * - 需要多个输入才能产生一个输出的级(例如打包)每次只消耗输入, 凑齐后再产生输出
+ * - 周期执行的源每个周期只调用一次, 由 pipeline_wake 唤醒的源反复调用直到返回0
+ * - 暂时无法处理(例如发送通道忙)时返回0, 条件满足后由外部调用 pipeline_wake 唤醒
+ * 
+ * 示例(ADC采样 → 滤波 → 打包 → 发布):
+ * 
+ *	static uint8_t adc_read(const void *in, void *out, void *arg)
+ *	{
+ *		*(uint16_t *)out = ADC_DATA;
+ *		return PIPE_PRODUCED;
+ *	}
+ *
+ *	static struct queue_info raw_q, flt_q, pkt_q;
+ *	static uint16_t raw_buf[16], flt_buf[16];
+ *	static struct frame pkt_buf[4];
+ *
+ *	queue_init(&raw_q, sizeof(uint16_t), raw_buf, 16);
+ *	queue_init(&flt_q, sizeof(uint16_t), flt_buf, 16);
+ *	queue_init(&pkt_q, sizeof(struct frame), pkt_buf, 4);
+ *
+ *	pipe_handle pipe = pipeline_create("sensor");
+ *	struct pipe_stage_attr attr = { .name = "adc", .f = adc_read, .out = &raw_q, .period_ms = 1 };
+ *	pipeline_add_stage(pipe, &attr);
+ *	attr = (struct pipe_stage_attr){ .name = "filter", .f = filter, .out = &flt_q };
+ *	pipeline_add_stage(pipe, &attr);
+ *	attr = (struct pipe_stage_attr){ .name = "pack", .f = pack, .out = &pkt_q };
+ *	pipeline_add_stage(pipe, &attr);
+ *	attr = (struct pipe_stage_attr){ .name = "publish", .f = publish };
+ *	pipeline_add_stage(pipe, &attr);
+ */
+
+#define PIPE_MAX_STAGE (8)	 /* 单条流水线最多的级数 */
+#define PIPE_STAGE_BATCH (8) /* 一级每次执行最多处理的单元数 超出后重新排队, 避免长时间占用主循环 */
+
+#define PIPE_CONSUMED (1U << 0) /* 级函数返回值: 消耗了一个输入单元 */
+#define PIPE_PRODUCED (1U << 1) /* 级函数返回值: 产生了一个输出单元 */
+
+/**
+ * @brief 级函数
+ * 
+ * @param in 输入单元 位于输入队列中, 源为NULL
+ * @param out 输出单元的空间 位于输出队列中, 最后一级为NULL
+ * @param arg 创建时提供的参数
+ * @return uint8_t PIPE_CONSUMED 与 PIPE_PRODUCED 的组合 为0时本次执行结束
+ */
+typedef uint8_t (*pipe_stage_f)(const void *in, void *out, void *arg);
+
+typedef struct pipeline *pipe_handle;
+typedef struct pipe_stage *pipe_stage_handle;
+
+/**
+ * @brief 级参数
+ * 
+ * 除第一级外, 每一级的输入队列都是上一级的输出队列
+ */
+struct pipe_stage_attr {
+	const char *name;		/* 级名 用于统计输出 可为NULL */
+	pipe_stage_f f;			/* 级函数 */
+	void *arg;				/* 级函数的参数 */
+	struct queue_info *in;	/* 输入队列 只用于第一级, 由外部写入后调用 pipeline_wake; 为NULL时第一级为源 */
+	struct queue_info *out;	/* 输出队列 最后一级为NULL */
+	uint32_t period_ms;		/* 源的执行周期,单位毫秒 为0时由 pipeline_wake 唤醒 */
+};
+
+/**
+ * @brief 级统计
+ */
+struct pipe_stage_stat {
+	uint32_t runs;		/* 执行次数 */
+	uint32_t in_units;	/* 消耗的输入单元数 */
+	uint32_t out_units;	/* 产生的输出单元数 */
+	uint32_t stalls;	/* 因输出队列已满而停止的次数 */
+	uint32_t busy_us;	/* 累计执行时间,单位微秒 */
+};
+
+/**
+ * @brief 创建流水线
+ * 
+ * @param name 流水线名 可为NULL
+ * @return pipe_handle 成功返回句柄，失败返回NULL
+ */
+pipe_handle pipeline_create(const char *name);
+
+/**
+ * @brief 在流水线末尾添加一级 在默认调度器实例中创建对应的任务
+ * 
+ * @param pipe 流水线句柄
+ * @param attr 级参数
+ * @return pipe_stage_handle 成功返回句柄，失败返回NULL
+ */
+pipe_stage_handle pipeline_add_stage(pipe_handle pipe, const struct pipe_stage_attr *attr);
+
+/**
+ * @brief 唤醒一级 可在中断中调用
+ * 
+ * 向第一级的输入队列写入数据后, 或事件驱动的源有新数据时调用
+ * 
+ * @param stage 级句柄
+ * @return bool 成功返回true，投递队列已满返回false
+ */
+bool pipeline_wake(pipe_stage_handle stage);
+
+/**
+ * @brief 获取一级的统计
+ * 
+ * @param stage 级句柄
+ * @param stat 输出统计
+ * @return bool 成功返回true，失败返回false
+ */
+bool pipeline_get_stat(pipe_stage_handle stage, struct pipe_stage_stat *stat);
+
+/**
+ * @brief 清零流水线所有级的统计
+ * 
+ * @param pipe 流水线句柄
+ */
+void pipeline_reset_stat(pipe_handle pipe);
+
+/**
+ * @brief 遍历流水线的各级
+ * 
+ * @param pipe 流水线句柄
+ * @param prev 上一级 为NULL时返回第一级
+ * @return pipe_stage_handle 下一级 没有更多时返回NULL
+ */
+pipe_stage_handle pipeline_stage_next(pipe_handle pipe, pipe_stage_handle prev);
+
+/**
+ * @brief 获取级名
+ * 
+ * @param stage 级句柄
+ * @return const char* 级名 未设置时为空字符串
+ */
+const char *pipeline_stage_name(pipe_stage_handle stage);
+
+#endif /* __VIRTUAL_OS_PIPELINE_H__ */
@@ -151,4 +151,46 @@ void queue_advance_rd(struct queue_info *q, size_t units);
  */
 void queue_advance_wr(struct queue_info *q, size_t units);
 
+/**
+ * @brief 获取队列中可连续读取的区域 用于不拷贝直接访问队列中的数据
+ *
+ * 读取完成后调用`queue_advance_rd`移除; 数据跨越缓冲区末尾时只返回末尾之前的部分
+ *
+ * @param q     指向队列实例的指针
+ * @param units 返回可连续读取的单元数
+ * @return void* 区域起始地址 队列为空时返回NULL
+ */
+void *queue_read_span(struct queue_info *q, size_t *units);
+
+/**
+ * @brief 获取队列中可连续写入的区域 用于直接在队列中填充数据
+ *
+ * 填充完成后调用`queue_advance_wr`提交; 空闲空间跨越缓冲区末尾时只返回末尾之前的部分
+ *
+ * @param q     指向队列实例的指针
+ * @param units 返回可连续写入的单元数
+ * @return void* 区域起始地址 队列已满时返回NULL
+ */
+void *queue_write_span(struct queue_info *q, size_t *units);
+
+/**
+ * @brief 获取队列中最早的一个单元 用于不拷贝直接处理单个单元
+ *
+ * 处理完成后调用`queue_advance_rd`移除
+ *
+ * @param q     指向队列实例的指针
+ * @return void* 单元地址 队列为空时返回NULL
+ */
+void *queue_rd_unit(struct queue_info *q);
+
+/**
+ * @brief 获取队列中下一个可写入的单元 用于直接在队列中填充单个单元
+ *
+ * 填充完成后调用`queue_advance_wr`提交
+ *
+ * @param q     指向队列实例的指针
+ * @return void* 单元地址 队列已满时返回NULL
+ */
+void *queue_wr_unit(struct queue_info *q);
+
 #endif /* __VIRTUAL_OS_QUEUE_H__ */
@@ -0,0 +1,155 @@
+/**
+ * @file robin_hash.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 开放寻址的字符串哈希表
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_ROBIN_HASH_H__
+#define __VIRTUAL_OS_ROBIN_HASH_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "utils/string_hash.h"
+
+/**
+ * 开放寻址(Robin Hood)的字符串哈希表, 与 string_hash 相比:
+ * 
+ * 1. 所有槽位位于一块连续内存, 槽位中保存完整的哈希值, 查找时先比较哈希值, 只有哈希值相同才比较字符串
+ * 2. 插入时探测距离较短的元素让位给较长的元素, 探测距离保持均衡, 遇到探测距离更短的槽位即可确定键不存在
+ * 3. 键复制到按块分配的字符串区中, 不再为每个键单独分配内存; 删除的键占用的空间在表清空时释放,
+ *    或者在累计超过一块且超过存活的键时把存活的键复制到一个新块中回收, 反复插入删除时内存不会持续增长
+ * 4. 元素数超过容量的 7/8 时容量加倍, 扩容时使用保存的哈希值, 不需要重新计算
+ * 5. 使用 robin_hash_next 遍历, 不分配内存, 遍历期间不能插入或删除
+ * 
+ * 示例:
+ * 
+ *	struct robin_hash table;
+ *	size_t iter = 0;
+ *	const char *key;
+ *	void *value;
+ *
+ *	robin_hash_init(&table, 16);
+ *	robin_hash_insert(&table, "uart1", &uart1_dev);
+ *	while (robin_hash_next(&table, &iter, &key, &value))
+ *		printf("%s\n", key);
+ */
+
+#define ROBIN_HASH_ARENA_SIZE (256) /* 字符串区每块的大小(字节) 超出的长键单独成块 */
+
+// 槽位
+struct robin_slot {
+	uint32_t hash; // 键的哈希值
+	uint32_t dist; // 探测距离加1 0表示空槽位
+	const char *key;
+	void *private;
+};
+
+// 字符串区的一块
+struct robin_arena {
+	struct robin_arena *next;
+	size_t size;
+	size_t used;
+	char data[];
+};
+
+struct robin_hash {
+	struct robin_slot *slots;
+	size_t cap;	  // 容量 2的幂
+	size_t count; // 元素数
+	struct robin_arena *arena;
+	size_t key_bytes; // 存活的键占用的字节数
+	size_t garbage;	  // 已删除的键占用的字节数
+};
+
+/**
+ * @brief 哈希表初始化
+ *
+ * @param table 一个实例
+ * @param capacity 预计的元素数 按此分配初始容量, 超出后自动扩容
+ * @return enum hash_error 错误码
+ */
+enum hash_error robin_hash_init(struct robin_hash *table, size_t capacity);
+
+/**
+ * @brief 哈希插入 键已存在时替换数据
+ *
+ * @param table 表实例
+ * @param key 字符串 会被复制
+ * @param private 需要存储数据的指针
+ * @return enum hash_error 错误码
+ */
+enum hash_error robin_hash_insert(struct robin_hash *table, const char *key, void *private);
+
+/**
+ * @brief 哈希查找
+ *
+ * @param table 表实例
+ * @param key 字符串
+ * @param error 错误码,不考虑设为NULL
+ * @return void* 返回存储的指针,自行强转
+ */
+void *robin_hash_find(struct robin_hash *table, const char *key, enum hash_error *error);
+
+/**
+ * @brief 删除哈希键
+ *
+ * @param table 表实例
+ * @param key 字符串
+ * @return enum hash_error 错误码
+ */
+enum hash_error robin_hash_delete(struct robin_hash *table, const char *key);
+
+/**
+ * @brief 获取元素数
+ *
+ * @param table 表实例
+ * @return size_t 元素数
+ */
+size_t robin_hash_count(struct robin_hash *table);
+
+/**
+ * @brief 遍历所有元素 不分配内存
+ *
+ * @param table 表实例
+ * @param iter 遍历位置 首次调用前置0
+ * @param key 输出键 可为NULL 删除任意键之后可能失效
+ * @param private 输出数据 可为NULL
+ * @return bool 取得一个元素返回true, 遍历结束返回false
+ */
+bool robin_hash_next(struct robin_hash *table, size_t *iter, const char **key, void **private);
+
+/**
+ * @brief 删除表
+ *
+ * @param table 表实例
+ */
+void robin_hash_destroy(struct robin_hash *table);
+
+#endif /* __VIRTUAL_OS_ROBIN_HASH_H__ */
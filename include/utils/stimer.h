@@ -33,47 +33,617 @@
 #ifndef __VIRTUAL_OS_STIMER_H__
 #define __VIRTUAL_OS_STIMER_H__
 
-#define STIMER_PERIOD_PER_TICK_MS (1)
+#define STIMER_TICK_US (1000)							  /* 节拍周期,单位微秒 必须为1000的约数或倍数, 例如100或1000 */
+#define STIMER_PERIOD_PER_TICK_MS (STIMER_TICK_US / 1000) /* 节拍周期,单位毫秒 节拍小于1毫秒时为0 */
+
+// 1:启用 0:不启用
+#define STIMER_ENABLE_PROFILE (0)  /* 启用任务性能统计 需要移植接口提供 f_get_cycle */
+#define STIMER_ENABLE_GOVERNOR (0) /* 启用过载降级 需要同时启用 STIMER_ENABLE_PROFILE */
+#define STIMER_ENABLE_STAGGER (1)  /* 创建周期任务时自动错开相位 */
+#define STIMER_ENABLE_BUDGET (0)   /* 启用可调度性检查与执行时间预算 */
+
+#define STIMER_SHED_LEVELS (3)			/* 降级等级数 */
+#define STIMER_GOVERNOR_WINDOW_MS (100)	/* 负载率的统计窗口 */
+#define STIMER_GOVERNOR_HIGH (900)		/* 窗口内负载率高于该千分比时提升一级降级等级 */
+#define STIMER_GOVERNOR_LOW (600)		/* 窗口内负载率低于该千分比时降低一级降级等级 */
+
+#define STIMER_WORK_QUEUE_SIZE (16)	/* 中断投递队列容量 必须为2的幂 */
+#define STIMER_MAX_TIMER (16)		/* 软件定时器(含单次任务)的最大数量 */
+#define STIMER_STAGGER_SLOTS (60)	/* 错峰负载表的槽位数 约数越多, 常用周期可选的相位越多 */
+#define STIMER_UTIL_LIMIT (1000)	/* 可调度性检查允许的总利用率 千分比 */
+#define STIMER_ADMISSION_REJECT (1) /* 1: 不可调度时拒绝创建任务 0: 仍然创建, 由 stimer_get_sched_info 查询 */
+#define STIMER_MAX_FAST_TASK (4)	/* 在节拍中断中执行的快速任务的最大数量 为0时不启用 */
+#define STIMER_FAST_MAX_US (50)		/* 快速任务允许的最长执行时间,单位微秒 */
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "utils/list.h"
 
 /**************************************系统API**************************************/
 
 typedef void (*stimer_timeout_process)(void);
 typedef void (*stimer_base_init)(uint32_t period_ms, stimer_timeout_process f_timeout);
+typedef void (*stimer_base_init_us)(uint32_t period_us, stimer_timeout_process f_timeout);
 typedef void (*stimer_base_start)(void);
 
+typedef void (*stimer_base_wakeup)(uint32_t ticks);
+typedef uint32_t (*stimer_base_idle)(void);
+typedef uint32_t (*stimer_base_cycle)(void);
+
 typedef void (*stimer_f)(void);
+typedef void (*stimer_work_f)(void *arg);
 
+/**
+ * @brief 调度定时器移植接口
+ * 
+ * f_start 必须提供, f_init 与 f_init_us 至少提供一个, 都提供时使用 f_init_us, 节拍小于1毫秒时必须提供 f_init_us
+ * 
+ * f_wakeup 与 f_idle 为可选的低功耗接口:
+ * 
+ * 1. 仅提供 f_idle: 没有待处理的节拍时调用 f_idle 进入休眠, 由下一次节拍中断唤醒, f_idle 返回0
+ * 2. 同时提供 f_wakeup 与 f_idle(无节拍模式): 调度器计算距离最近一个到期任务的节拍数 ticks,
+ *    先调用 f_wakeup(ticks) 暂停周期节拍并设置一次单次唤醒, 再调用 f_idle 休眠,
+ *    唤醒后(单次定时到期或其他中断) f_idle 恢复周期节拍, 并返回休眠期间实际经过的节拍数, 调度器据此修正当前节拍
+ * 
+ * 注意:
+ * - 单次唤醒中断中不要调用节拍回调 f_timeout, 休眠期间经过的节拍只通过 f_idle 的返回值上报
+ * - 硬件定时范围不足时 f_wakeup 可以提前唤醒, 提前唤醒只会多一次循环, 不影响任务的到期时间
+ * - f_idle 中应在关中断的状态下执行 WFI 等休眠指令再开中断, 避免在进入休眠前到来的中断被错过
+ * - 关中断后可以调用 stimer_work_pending 再确认一次, 有待处理的投递时直接返回, 不进入休眠
+ * 
+ * f_get_cycle 与 cycle_per_us 用于性能统计(STIMER_ENABLE_PROFILE)与执行时间预算(STIMER_ENABLE_BUDGET),
+ * 提供一个自由运行的32位计数器, 例如 Cortex-M3/M4 的 DWT->CYCCNT, 或主机上由 clock_gettime 换算的计数
+ * 
+ * f_get_subtick 用于 stimer_now_us 的节拍内插值, 返回自最近一次节拍中断以来经过的微秒数, 例如由 SysTick->VAL 换算,
+ * 计数器已重装但节拍中断尚未执行时(例如在更高优先级的中断中读取), 应检查挂起标志并返回加上一个节拍后的值
+ */
 struct timer_port {
-	volatile stimer_base_init f_init;
-	volatile stimer_base_start f_start;
+	volatile stimer_base_init f_init;		  /* 定时器初始化 周期单位为毫秒 */
+	volatile stimer_base_init_us f_init_us;	  /* 定时器初始化 周期单位为微秒 */
+	volatile stimer_base_start f_start;		  /* 定时器启动 */
+	volatile stimer_base_wakeup f_wakeup;	  /* 可选 暂停周期节拍, ticks 个节拍后单次唤醒 */
+	volatile stimer_base_idle f_idle;		  /* 可选 休眠直到被中断唤醒, 返回暂停周期节拍期间经过的节拍数 */
+	volatile stimer_base_cycle f_get_cycle;	  /* 可选 读取自由运行的计数器 */
+	uint32_t cycle_per_us;					  /* 计数器每微秒的计数值 */
+	volatile stimer_base_cycle f_get_subtick; /* 可选 读取当前节拍内已经过的微秒数 */
 };
 
 /**
  * @brief 调度定时器初始化
  * 
- * @param port 提供一个 定时器的初始化函数和启动函数
+ * @param port 提供一个 定时器的初始化函数和启动函数, 以及可选的低功耗接口
  * @return bool 成功返回true，失败返回false
  */
 bool stimer_init(struct timer_port *port);
 
 /**************************************用户可用API**************************************/
 
+typedef struct stimer_task *stimer_handle;
+typedef struct stimer_task *stimer_timer_handle;
+
+struct stimer_ctx;
+
+/**
+ * @brief 任务跟踪事件 用于仿真
+ */
+enum stimer_trace_event {
+	STIMER_TRACE_RELEASE, /* 周期释放 tick 为名义释放节拍 */
+	STIMER_TRACE_START,	  /* 开始执行 */
+	STIMER_TRACE_END,	  /* 执行结束 */
+};
+
+/**
+ * @brief 任务跟踪函数
+ * 
+ * @param arg 设置跟踪函数时提供的参数
+ * @param task 任务句柄
+ * @param ev 事件
+ * @param tick 事件发生的节拍
+ */
+typedef void (*stimer_trace_f)(void *arg, struct stimer_task *task, enum stimer_trace_event ev, uint32_t tick);
+
+/**
+ * @brief 任务错过释放时的处理策略
+ * 
+ * 当某个任务执行过久导致其他任务的释放节拍已经过去时, 调度器会逐个节拍追赶,
+ * 若追赶时某个任务已落后一个周期以上, 则按此策略处理错过的释放
+ */
+enum stimer_overrun_policy {
+	STIMER_OVERRUN_CATCH_UP, /* 追赶: 错过的每一次释放都依次补执行(默认) */
+	STIMER_OVERRUN_SKIP,	 /* 跳过: 丢弃错过的释放, 从下一个未来的周期点继续 */
+	STIMER_OVERRUN_COALESCE, /* 合并: 错过的释放合并为一次立即执行, 从下一个未来的周期点继续 */
+};
+
+/**
+ * @brief 任务的执行层级
+ * 
+ * 快速任务在节拍中断中执行, 不受主循环中其他任务执行时间的影响, 适合1毫秒采样等硬实时的短任务, 但必须遵守:
+ * 1. 执行时间不超过 STIMER_FAST_MAX_US, 声明的 wcet_us 超出时创建失败, 启用性能统计时超出的执行计入 budget_overrun
+ * 2. 只能调用可在中断中调用的接口, 例如 stimer_task_notify、stimer_work_submit、stimer_now_us
+ * 3. 不能阻塞或等待, 与主循环共享的数据需要按中断与主循环的方式保护
+ * 
+ * 快速任务每个节拍检查一次, 到期即执行, 不参与错峰、过载降级与错过释放的处理,
+ * 不支持 stimer_task_delay 与 stimer_task_notify, 存在快速任务时无节拍模式不会暂停周期节拍
+ */
+enum stimer_tier {
+	STIMER_TIER_NORMAL, /* 在主循环中执行(默认) */
+	STIMER_TIER_FAST,	/* 在节拍中断中执行 */
+};
+
+/**
+ * @brief 任务创建参数
+ * 
+ * shed_period_ms 用于过载降级(STIMER_ENABLE_GOVERNOR), 第 n 级降级时任务周期为 shed_period_ms[n - 1],
+ * 关键任务全部保持为0即可, 不会被降级
+ * 
+ * 同一节拍到期的多个任务按以下顺序执行:
+ * 1. 优先级高的任务先执行
+ * 2. 优先级相同时, 绝对截止时间(释放节拍 + 相对截止时间)早的任务先执行
+ * 3. 以上都相同时按放入时间轮的先后顺序执行
+ * 
+ * 启用 STIMER_ENABLE_STAGGER 时, 周期任务的首次释放会在一个周期内错开, 避免同周期的任务集中在同一个节拍:
+ * 调度器按已有任务的执行时间统计每个相位的负载, 选择负载最低的相位, 首次释放不会晚于未错峰时的一个周期
+ * 执行时间优先使用 wcet_us, 为0时使用性能统计测得的平均执行时间(STIMER_ENABLE_PROFILE), 都没有时按1微秒计
+ * 需要与创建节拍保持对齐(例如与其他任务有固定的相位关系)的任务设置 no_stagger
+ */
+struct stimer_task_attr {
+	const char *name;							 /* 任务名 用于统计输出 可为NULL */
+	stimer_f init_f;							 /* 初始化函数指针 可为NULL */
+	stimer_f task_f;							 /* 任务函数指针 */
+	uint32_t period_ms;							 /* 任务周期,单位毫秒 为0时为事件任务 */
+	uint32_t period_us;							 /* 任务周期,单位微秒 非0时代替 period_ms, 用于小于1毫秒的节拍 */
+	enum stimer_overrun_policy overrun;			 /* 错过释放时的处理策略 */
+	uint8_t priority;							 /* 优先级 数值越大越优先 默认0 */
+	uint32_t deadline_ms;						 /* 相对截止时间,单位毫秒 为0时等于周期 */
+	uint32_t shed_period_ms[STIMER_SHED_LEVELS]; /* 各降级等级下的周期 为0时沿用上一等级的周期 */
+	uint32_t wcet_us;							 /* 声明的执行时间,单位微秒 用于错峰 可为0 */
+	bool no_stagger;							 /* 不错开相位 首次释放固定在一个周期后 */
+	enum stimer_tier tier;						 /* 执行层级 快速任务不能为事件任务 */
+	void *arg;									 /* 任务参数 任务中由 stimer_task_arg 读取 可为NULL */
+};
+
+/**
+ * @brief 任务释放统计
+ */
+struct stimer_task_stat {
+	uint32_t runs;			 /* 执行次数 */
+	uint32_t late;			 /* 晚于释放节拍才开始执行的次数 */
+	uint32_t lost;			 /* 因跳过或合并而未执行的释放次数 */
+	uint32_t max_lag;		 /* 最大释放延迟,单位节拍 */
+	uint32_t budget_overrun; /* 执行时间超出 wcet_us 的次数(STIMER_ENABLE_BUDGET) */
+};
+
+#if STIMER_ENABLE_PROFILE
+// 性能统计原始数据 单位为计数器的计数值
+struct stimer_prof_data {
+	uint32_t count;
+	uint32_t exec_min;
+	uint32_t exec_max;
+	uint64_t exec_sum;
+	uint32_t latency_max;
+	uint64_t latency_sum;
+};
+#endif
+
+// 时间轮中的节点类型
+enum stimer_kind {
+	STIMER_KIND_TASK,  // 周期任务与事件任务
+	STIMER_KIND_TIMER, // 软件定时器
+	STIMER_KIND_DEFER, // 单次任务 执行后自动释放
+	STIMER_KIND_FAST,  // 快速任务 在节拍中断中执行, 不进入时间轮
+};
+
+/**
+ * @brief 任务控制块
+ * 
+ * 仅为支持静态创建任务(EXPORT_TASK)而公开, 成员只能由调度组件内部访问
+ */
+struct stimer_task {
+	struct stimer_ctx *ctx; // 所属的调度器实例
+	const char *name;
+	union {
+		stimer_f task_f;	   // 任务与单次任务的函数
+		stimer_work_f timer_f; // 软件定时器的函数
+	};
+	void *arg;					  // 软件定时器与任务的参数
+	uint32_t period;			  // 周期(节拍)
+	uint32_t expires;			  // 下次到期的节拍
+	list_item item;				  // 时间轮节点 软件定时器未启动时为空闲链表节点或未链接
+	list_item node;				  // 任务链表节点
+	struct stimer_task_stat stat; // 释放统计
+#if STIMER_ENABLE_PROFILE
+	struct stimer_prof_data prof; // 性能统计
+#endif
+#if STIMER_ENABLE_GOVERNOR
+	uint32_t base_period;					  // 正常运行时的周期(节拍)
+	uint32_t shed_period[STIMER_SHED_LEVELS]; // 各降级等级下的周期(节拍) 0表示沿用上一等级
+#endif
+	uint32_t deadline;		  // 相对截止时间(节拍) 0表示等于周期
+	uint32_t wcet_us;		  // 声明的执行时间(微秒) 用于错峰与预算
+#if STIMER_ENABLE_BUDGET
+	uint32_t wcet_max_us; // 测得的最长执行时间(微秒)
+#endif
+#if STIMER_MAX_FAST_TASK > 0
+	volatile uint32_t period_req; // 快速任务待生效的周期(节拍) 由节拍中断应用, 0表示没有
+#endif
+	uint8_t priority;		  // 优先级
+	uint8_t overrun;		  // 错过释放时的处理策略
+	uint8_t kind;			  // 节点类型
+	uint8_t suspended;		  // 已挂起
+	uint8_t is_static;		  // 任务控制块由调用者提供
+	volatile uint8_t pending; // 已被通知 尚未执行
+};
+
 /**
  * @brief 创建周期任务
  * 
  * @param init_f 初始化函数指针
  * @param task_f 任务函数指针
- * @param period_ms 任务周期,单位毫秒
+ * @param period_ms 任务周期,单位毫秒 为0时创建事件任务
  * @return bool 成功返回true，失败返回false
  */
 bool stimer_task_create(stimer_f init_f, stimer_f task_f, uint32_t period_ms);
 
+/**
+ * @brief 按参数创建任务
+ * 
+ * period_ms 为0时创建事件任务, 事件任务不会周期释放, 只在 stimer_task_notify 之后执行一次
+ * 
+ * @param attr 任务参数
+ * @return stimer_handle 成功返回任务句柄，失败返回NULL
+ */
+stimer_handle stimer_task_create_ex(const struct stimer_task_attr *attr);
+
+/**
+ * @brief 使用静态分配的任务控制块创建任务, 不使用堆内存
+ * 
+ * @param tcb 任务控制块 由调用者提供存储, 任务存在期间不能释放
+ * @param attr 任务参数
+ * @return stimer_handle 成功返回任务句柄，失败返回NULL
+ */
+stimer_handle stimer_task_create_static(struct stimer_task *tcb, const struct stimer_task_attr *attr);
+
+/**
+ * @brief 静态任务描述符 由 EXPORT_TASK 生成, 存放在 .early_task 段中
+ */
+struct stimer_task_desc {
+	struct stimer_task *tcb;	  /* 任务控制块 存放在 .early_task_tcb 段中 */
+	struct stimer_task_attr attr; /* 任务参数 */
+};
+
+/**
+ * @brief 静态任务注册宏
+ * 
+ * 例如: EXPORT_TASK(app_led_init, app_led_task, 100);
+ * 描述符集中存放在 .early_task 段(FLASH), 任务控制块集中存放在 .early_task_tcb 段(RAM),
+ * virtual_os_init 在调度器初始化后依次创建这些任务, 不使用堆内存
+ * init 与 task 需要在使用此宏之前声明, init 可以为NULL, 任务名即为任务函数名
+ * 
+ */
+#define EXPORT_TASK(_init, _task, _period)                                                                             \
+	static struct stimer_task _task##_tcb __attribute__((section(".early_task_tcb"), used));                           \
+	static const struct stimer_task_desc _task##_desc                                                                  \
+		__attribute__((section(".early_task"), used, aligned(sizeof(void *)))) = {                                     \
+			.tcb = &_task##_tcb,                                                                                       \
+			.attr = { .name = #_task, .init_f = _init, .task_f = _task, .period_ms = _period },                        \
+		}
+
+/**
+ * @brief 获取任务的释放统计
+ * 
+ * @param task 任务句柄
+ * @param stat 输出统计信息
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_get_stat(stimer_handle task, struct stimer_task_stat *stat);
+
+/**
+ * @brief 遍历所有周期任务
+ * 
+ * @param task 上一个任务句柄, 为NULL时返回第一个任务
+ * @return stimer_handle 下一个任务句柄, 遍历结束返回NULL
+ */
+stimer_handle stimer_task_next(stimer_handle task);
+
+/**
+ * @brief 获取任务的执行层级
+ * 
+ * @param task 任务句柄
+ * @return enum stimer_tier 执行层级
+ */
+enum stimer_tier stimer_task_get_tier(stimer_handle task);
+
+/**
+ * @brief 获取任务名
+ * 
+ * @param task 任务句柄
+ * @return const char* 任务名, 未设置时返回"-"
+ */
+const char *stimer_task_name(stimer_handle task);
+
+/**
+ * @brief 获取任务参数
+ * 
+ * 多个任务共用一个任务函数时, 在任务中调用 stimer_task_arg(stimer_self()) 区分各自的上下文
+ * 
+ * @param task 任务句柄
+ * @return void* 创建时的 arg, 未设置时返回NULL
+ */
+void *stimer_task_arg(stimer_handle task);
+
+/**
+ * @brief 获取当前正在执行的周期任务
+ * 
+ * 多个调度器实例在不同线程中运行时只对默认实例有效, 其他实例使用 stimer_ctx_self
+ * 
+ * @return stimer_handle 当前任务句柄, 不在周期任务中调用时返回NULL
+ */
+stimer_handle stimer_self(void);
+
+/**
+ * @brief 将任务的下一次释放推迟到指定时间之后, 之后按周期继续释放
+ * 
+ * 只能在主循环(任务)中调用, 不能在中断中调用, 不支持事件任务
+ * 
+ * @param task 任务句柄
+ * @param ms 从当前节拍起推迟的毫秒数, 为0时在下一个节拍释放
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_delay(stimer_handle task, uint32_t ms);
+
+/**
+ * @brief 通知任务执行一次 可在中断中调用
+ * 
+ * 任务在主循环的下一次循环中执行, 执行前的多次通知合并为一次
+ * 周期任务被通知时额外执行一次, 不影响原有的周期释放
+ * 
+ * @param task 任务句柄
+ * @return bool 成功返回true, 投递队列已满返回false
+ */
+bool stimer_task_notify(stimer_handle task);
+
+/**
+ * @brief 修改任务周期
+ * 
+ * 新周期比距离下一次释放的时间更短时, 从当前节拍起按新周期释放, 否则下一次释放不变
+ * 启用过载降级时修改的是正常周期, 降级期间实际周期仍由降级等级决定
+ * 
+ * @param task 任务句柄 不支持事件任务
+ * @param period_ms 新周期,单位毫秒
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_set_period(stimer_handle task, uint32_t period_ms);
+
+/**
+ * @brief 挂起任务, 挂起期间不会被释放, 通知也会被忽略
+ * 
+ * @param task 任务句柄
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_suspend(stimer_handle task);
+
+/**
+ * @brief 恢复被挂起的任务, 从当前节拍起按周期释放
+ * 
+ * @param task 任务句柄
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_resume(stimer_handle task);
+
+#if STIMER_ENABLE_BUDGET
+
+/**
+ * @brief 执行时间超出预算时的处理
+ */
+enum stimer_budget_action {
+	STIMER_BUDGET_IGNORE, /* 只计数 */
+	STIMER_BUDGET_SKIP,	  /* 跳过下一次周期释放 */
+	STIMER_BUDGET_DEMOTE, /* 优先级降为0 */
+};
+
+/**
+ * @brief 执行时间超出预算的钩子函数, 在任务返回后立即调用, 可以在其中输出日志
+ * 
+ * @param task 任务句柄
+ * @param exec_us 本次执行时间,单位微秒
+ * @return enum stimer_budget_action 处理方式
+ */
+typedef enum stimer_budget_action (*stimer_budget_hook)(stimer_handle task, uint32_t exec_us);
+
+/**
+ * @brief 可调度性分析结果
+ */
+struct stimer_sched_info {
+	uint32_t utilization; /* 周期任务的总利用率 千分比 */
+	uint32_t max_wcet_us; /* 最长的执行时间 */
+	bool schedulable;	  /* 是否可调度 */
+};
+
+/**
+ * @brief 设置执行时间超出预算的钩子函数
+ * 
+ * 每次任务执行都会计时, 声明了 wcet_us 的任务执行时间超出 wcet_us 时计入 budget_overrun 并调用钩子函数
+ * 移植接口提供 f_get_cycle 时按计数器计时, 精度为一个计数; 否则使用 stimer_now_us,
+ * 未提供 f_get_subtick 时精度为一个节拍, 短于一个节拍的 wcet_us 实际上不会被检查
+ * 
+ * @param hook 钩子函数 为NULL时只计数
+ */
+void stimer_set_budget_hook(stimer_budget_hook hook);
+
+/**
+ * @brief 对当前所有周期任务做可调度性分析
+ * 
+ * 任务之间不会抢占, 满足以下条件时认为可调度:
+ * 1. 所有周期任务的 执行时间 / 周期 之和不超过 STIMER_UTIL_LIMIT
+ * 2. 每个周期任务的 执行时间 + 其他任务中最长的执行时间 不超过其相对截止时间
+ * 执行时间取声明的 wcet_us, 未声明时取运行中测得的最大值
+ * 创建任务时会以同样的条件做准入检查, 不满足时按 STIMER_ADMISSION_REJECT 拒绝创建
+ * 
+ * @param info 输出分析结果
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_get_sched_info(struct stimer_sched_info *info);
+
+#endif /* STIMER_ENABLE_BUDGET */
+
+/**
+ * @brief 获取上电后经过的时间 可在中断中调用
+ * 
+ * 由64位节拍计数与移植接口 f_get_subtick 的节拍内插值组成, 单调递增, 不会回绕
+ * 未提供 f_get_subtick 时精度为一个节拍
+ * 无节拍休眠期间节拍暂停计数, 唤醒休眠的中断中读取到的是进入休眠时的时间
+ * 
+ * @return uint64_t 微秒数
+ */
+uint64_t stimer_now_us(void);
+
+/**
+ * @brief 获取上电后经过的毫秒数 可在中断中调用
+ * 
+ * 约49天回绕一次, 计算超时时使用差值 (now - start) 即可跨越回绕
+ * 
+ * @return uint32_t 毫秒数
+ */
+uint32_t stimer_now_ms(void);
+
+/**
+ * @brief 投递一个工作到主循环执行 可在中断中调用
+ * 
+ * 工作按投递顺序在主循环的下一次循环中执行, 支持不同优先级的中断同时投递(无锁)
+ * 
+ * @param f 工作函数
+ * @param arg 工作函数参数
+ * @return bool 成功返回true, 投递队列已满返回false
+ */
+bool stimer_work_submit(stimer_work_f f, void *arg);
+
+/**
+ * @brief 是否有尚未执行的投递 可在中断中调用
+ * 
+ * @return bool 有待执行的工作或通知返回true
+ */
+bool stimer_work_pending(void);
+
+#if STIMER_ENABLE_PROFILE
+
+/**
+ * @brief 任务性能统计 时间单位均为微秒
+ */
+struct stimer_task_prof {
+	uint32_t count;		  /* 执行次数 */
+	uint32_t exec_min;	  /* 最短执行时间 */
+	uint32_t exec_avg;	  /* 平均执行时间 */
+	uint32_t exec_max;	  /* 最长执行时间 */
+	uint32_t latency_avg; /* 平均释放延迟(释放节拍到开始执行) */
+	uint32_t latency_max; /* 最大释放延迟 */
+};
+
+/**
+ * @brief 调度循环负载统计 时间单位均为微秒
+ * 
+ * 快速任务在节拍中断中执行, 其时间同时包含在被打断的主循环的忙或闲时间中
+ */
+struct stimer_load {
+	uint32_t busy_us;	 /* 主循环处理节拍与执行任务的时间 */
+	uint32_t idle_us;	 /* 主循环空闲(空转或休眠)的时间 */
+	uint16_t usage;		 /* 主循环负载率 千分比 */
+	uint32_t fast_us;	 /* 节拍中断中执行快速任务的时间 */
+	uint16_t fast_usage; /* 快速任务的负载率 千分比 */
+};
+
+/**
+ * @brief 获取任务的性能统计
+ * 
+ * @param task 任务句柄
+ * @param prof 输出统计信息
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_task_get_prof(stimer_handle task, struct stimer_task_prof *prof);
+
+/**
+ * @brief 获取调度循环的负载统计
+ * 
+ * @param load 输出统计信息
+ */
+void stimer_get_load(struct stimer_load *load);
+
+/**
+ * @brief 清空所有性能统计, 重新开始统计
+ * 
+ */
+void stimer_prof_reset(void);
+
+#if STIMER_ENABLE_GOVERNOR
+
+/**
+ * @brief 获取当前的降级等级
+ * 
+ * 每个统计窗口结束时根据窗口内的负载率调整一级: 高于 STIMER_GOVERNOR_HIGH 时提升, 低于 STIMER_GOVERNOR_LOW 时降低
+ * 
+ * @return uint8_t 0为正常运行, 最大为 STIMER_SHED_LEVELS
+ */
+uint8_t stimer_get_shed_level(void);
+
+#endif /* STIMER_ENABLE_GOVERNOR */
+
+#endif /* STIMER_ENABLE_PROFILE */
+
+/**
+ * 软件定时器
+ * 
+ * 定时器与周期任务位于同一个时间轮中, 每个节拍的开销与等待中的定时器数量无关
+ * 定时器从容量为 STIMER_MAX_TIMER 的静态池中分配, 分配与释放均为O(1)
+ * 以下接口只能在主循环(任务)中调用, 中断中需要启动定时器时, 可以通过 stimer_work_submit 投递到主循环再启动
+ */
+
+/**
+ * @brief 创建软件定时器 创建后处于停止状态
+ * 
+ * @param f 到期时执行的函数
+ * @param arg 函数参数
+ * @return stimer_timer_handle 成功返回定时器句柄, 定时器已用完返回NULL
+ */
+stimer_timer_handle stimer_timer_create(stimer_work_f f, void *arg);
+
+/**
+ * @brief 启动定时器, 指定毫秒后执行一次, 已启动时重新计时
+ * 
+ * 可以在定时器的回调函数中重新启动, 实现周期执行
+ * 
+ * @param timer 定时器句柄
+ * @param ms 延时毫秒数
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_timer_start(stimer_timer_handle timer, uint32_t ms);
+
+/**
+ * @brief 停止定时器, 未启动或已到期时不做任何操作
+ * 
+ * @param timer 定时器句柄
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_timer_stop(stimer_timer_handle timer);
+
+/**
+ * @brief 定时器是否已启动且尚未到期
+ * 
+ * @param timer 定时器句柄
+ * @return bool 
+ */
+bool stimer_timer_is_active(stimer_timer_handle timer);
+
+/**
+ * @brief 删除定时器, 已启动时先停止, 删除后句柄失效
+ * 
+ * @param timer 定时器句柄
+ */
+void stimer_timer_delete(stimer_timer_handle timer);
+
 /**
  * @brief 运行时创建单次任务
  * 
+ * 从软件定时器池中分配, 执行后自动释放, 不能取消
+ * 
  * @param task_f 任务函数指针
  * @param ms 指定毫秒后执行
  * @return bool 成功返回true，失败返回false
@@ -86,4 +656,110 @@ bool defer_task_create(stimer_f task_f, uint32_t ms);
  */
 void stimer_start(void);
 
+/**
+ * 调度器实例
+ * 
+ * 以上接口都作用于默认实例(由 stimer_init 初始化, stimer_start 驱动)
+ * 以下接口用于在一个进程中创建多个互相独立的调度器实例, 例如在主机上仿真多个节点:
+ * - 实例不使用移植接口, 由 stimer_ctx_step 推进节拍, 每个实例可以在各自的线程中驱动
+ * - 任务与定时器句柄记录所属实例, stimer_task_* / stimer_timer_* 等接口可以直接用于实例中的句柄
+ * - 同一个实例的接口只能在驱动该实例的线程中调用, stimer_task_notify 与 stimer_ctx_work_submit 除外
+ */
+
+/**
+ * @brief 创建调度器实例 创建后即处于运行状态
+ * 
+ * @return struct stimer_ctx* 成功返回实例，失败返回NULL
+ */
+struct stimer_ctx *stimer_ctx_create(void);
+
+/**
+ * @brief 销毁调度器实例, 同时释放实例中动态创建的任务, 之后实例中的所有句柄失效
+ * 
+ * @param ctx 调度器实例
+ */
+void stimer_ctx_destroy(struct stimer_ctx *ctx);
+
+/**
+ * @brief 推进指定的节拍数, 逐个节拍执行投递的工作与到期的任务
+ * 
+ * 任务中通过 stimer_ctx_advance 推进的节拍同样计入, 已处理的节拍落后时先逐拍补齐
+ * 
+ * @param ctx 调度器实例
+ * @param ticks 节拍数
+ */
+void stimer_ctx_step(struct stimer_ctx *ctx, uint32_t ticks);
+
+/**
+ * @brief 推进指定的节拍数, 只执行快速任务, 不处理主循环
+ * 
+ * 在任务中调用, 模拟任务执行期间经过的时间
+ * 
+ * @param ctx 调度器实例
+ * @param ticks 节拍数
+ */
+void stimer_ctx_advance(struct stimer_ctx *ctx, uint32_t ticks);
+
+/**
+ * @brief 设置实例的任务跟踪函数, 每次周期释放、开始执行与执行结束时调用, 不能用于默认实例
+ * 
+ * @param ctx 调度器实例
+ * @param f 跟踪函数 为NULL时停止跟踪
+ * @param arg 跟踪函数的参数
+ */
+void stimer_ctx_set_trace(struct stimer_ctx *ctx, stimer_trace_f f, void *arg);
+
+/**
+ * @brief 获取实例的当前节拍
+ * 
+ * @param ctx 调度器实例
+ * @return uint32_t 当前节拍
+ */
+uint32_t stimer_ctx_get_tick(struct stimer_ctx *ctx);
+
+/**
+ * @brief 获取实例的当前时间, 实例没有节拍内插值, 精度为一个节拍
+ * 
+ * @param ctx 调度器实例
+ * @return uint64_t 微秒数
+ */
+uint64_t stimer_ctx_now_us(struct stimer_ctx *ctx);
+
+/**
+ * @brief 在实例中按参数创建任务
+ * 
+ * @param ctx 调度器实例
+ * @param attr 任务参数
+ * @return stimer_handle 成功返回任务句柄，失败返回NULL
+ */
+stimer_handle stimer_ctx_task_create(struct stimer_ctx *ctx, const struct stimer_task_attr *attr);
+
+/**
+ * @brief 在实例中创建软件定时器
+ * 
+ * @param ctx 调度器实例
+ * @param f 到期时执行的函数
+ * @param arg 函数参数
+ * @return stimer_timer_handle 成功返回定时器句柄, 定时器已用完返回NULL
+ */
+stimer_timer_handle stimer_ctx_timer_create(struct stimer_ctx *ctx, stimer_work_f f, void *arg);
+
+/**
+ * @brief 向实例投递一个工作 可在其他线程或中断中调用
+ * 
+ * @param ctx 调度器实例
+ * @param f 工作函数
+ * @param arg 工作函数参数
+ * @return bool 成功返回true, 投递队列已满返回false
+ */
+bool stimer_ctx_work_submit(struct stimer_ctx *ctx, stimer_work_f f, void *arg);
+
+/**
+ * @brief 获取实例中当前正在执行的任务
+ * 
+ * @param ctx 调度器实例
+ * @return stimer_handle 当前任务句柄, 没有正在执行的任务时返回NULL
+ */
+stimer_handle stimer_ctx_self(struct stimer_ctx *ctx);
+
 #endif /* __VIRTUAL_OS_STIMER_H__ */
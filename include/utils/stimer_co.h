@@ -0,0 +1,168 @@
+/**
+ * @file stimer_co.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 基于调度组件的无栈协程
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_STIMER_CO_H__
+#define __VIRTUAL_OS_STIMER_CO_H__
+
+/**
+ * 无栈协程(protothread风格), 协程本身就是一个普通的周期任务:
+ * 
+ * 1. 协程不占用独立的栈, 只保存一个续点, 等待时直接返回调度器, 其他任务得以继续执行
+ * 2. 下一次释放时从续点处继续执行, 运行到 CO_END 后下一次释放从头开始
+ * 3. 局部变量在等待前后不会保留, 需要跨等待使用的变量请定义为 static
+ * 4. 协程体内不能使用 switch 语句(续点本身基于 switch 实现)
+ * 5. CO_AWAIT_UNTIL 等条件等待在每次释放时检查一次条件, 检查间隔即任务周期
+ * 
+ * 示例:
+ * 
+ *	static void app_eeprom_task(void)
+ *	{
+ *		static struct stimer_co co;
+ *		static uint16_t page;
+ *
+ *		CO_BEGIN(&co);
+ *		for (page = 0; page < PAGE_NUM; page++) {
+ *			eeprom_page_write(page);
+ *			CO_AWAIT_MS(&co, 5);					// 等待写周期完成, 期间不阻塞其他任务
+ *			CO_AWAIT_UNTIL(&co, eeprom_is_standby());
+ *		}
+ *		CO_END(&co);
+ *	}
+ */
+
+#include <stdint.h>
+#include "utils/stimer.h"
+#include "utils/queue.h"
+
+/**
+ * @brief 协程上下文
+ */
+struct stimer_co {
+	uint16_t lc;	 /* 续点 为0时从头开始执行 */
+	uint8_t delayed; /* CO_AWAIT_MS 已推迟任务的释放 */
+	uint32_t start;	 /* CO_AWAIT_MS 开始等待的时间(毫秒) */
+};
+
+/**
+ * @brief 协程开始 必须位于协程体的最前面
+ * 
+ * @param co 协程上下文
+ */
+#define CO_BEGIN(co)                                                                                                   \
+	switch ((co)->lc) {                                                                                                \
+	case 0:
+
+/**
+ * @brief 协程结束 必须位于协程体的最后面, 下一次释放时从头开始执行
+ * 
+ * @param co 协程上下文
+ */
+#define CO_END(co)                                                                                                     \
+	}                                                                                                                  \
+	(co)->lc = 0
+
+/**
+ * @brief 让出执行权, 下一次释放时从此处继续执行
+ * 
+ * @param co 协程上下文
+ */
+#define CO_YIELD(co)                                                                                                   \
+	do {                                                                                                               \
+		(co)->lc = __LINE__;                                                                                           \
+		return;                                                                                                        \
+	case __LINE__:;                                                                                                    \
+	} while (0)
+
+/**
+ * @brief 等待条件成立, 条件不成立时让出执行权, 每次释放时重新检查
+ * 
+ * @param co 协程上下文
+ * @param cond 等待的条件
+ */
+#define CO_AWAIT_UNTIL(co, cond)                                                                                       \
+	do {                                                                                                               \
+		(co)->lc = __LINE__;                                                                                           \
+	case __LINE__:                                                                                                     \
+		if (!(cond))                                                                                                   \
+			return;                                                                                                    \
+	} while (0)
+
+/**
+ * @brief 等待指定的毫秒数
+ * 
+ * 优先通过 stimer_task_delay 推迟任务的下一次释放, 期间任务不会被释放; 推迟会永久改变任务的释放相位,
+ * 之后从恢复执行的节拍起按周期释放
+ * 无法推迟时(事件任务、快速任务, 或 stimer_self 返回NULL, 例如不在默认实例的任务中)退化为
+ * 每次释放时检查是否已经过 ms 毫秒, 不改变释放相位, 等待时间向上取整到任务周期; 事件任务只在被通知时检查
+ * 
+ * @param co 协程上下文
+ * @param ms 等待的毫秒数
+ */
+#define CO_AWAIT_MS(co, ms)                                                                                            \
+	do {                                                                                                               \
+		(co)->start = stimer_now_ms();                                                                                 \
+		(co)->delayed = stimer_task_delay(stimer_self(), (ms));                                                        \
+		(co)->lc = __LINE__;                                                                                           \
+		return;                                                                                                        \
+	case __LINE__:                                                                                                     \
+		if (!(co)->delayed && stimer_now_ms() - (co)->start < (uint32_t)(ms))                                          \
+			return;                                                                                                    \
+	} while (0)
+
+/**
+ * @brief 等待队列非空
+ * 
+ * @param co 协程上下文
+ * @param q 队列 struct queue_info *
+ */
+#define CO_AWAIT_QUEUE(co, q) CO_AWAIT_UNTIL(co, !is_queue_empty(q))
+
+/**
+ * @brief 等待标志置位 标志不会被自动清除
+ * 
+ * @param co 协程上下文
+ * @param flag 标志 可在中断中置位, 应定义为 volatile
+ */
+#define CO_AWAIT_FLAG(co, flag) CO_AWAIT_UNTIL(co, (flag))
+
+/**
+ * @brief 复位协程, 下一次释放时从头开始执行
+ * 
+ * @param co 协程上下文
+ */
+#define CO_RESTART(co)                                                                                                 \
+	do {                                                                                                               \
+		(co)->lc = 0;                                                                                                  \
+		return;                                                                                                        \
+	} while (0)
+
+#endif /* __VIRTUAL_OS_STIMER_CO_H__ */
@@ -0,0 +1,239 @@
+/**
+ * @file mailbox_bench.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 核间邮箱的主机性能测试 两个线程分别充当两个核
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ *
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "utils/mailbox.h"
+
+#define MB_UNITS (1024)			 /* 邮箱容量 */
+#define BATCH (8)				 /* 每批收发的消息数 */
+#define THROUGHPUT_MSGS (20000000) /* 吞吐量测试的默认消息数 */
+#define LATENCY_MSGS (100000)	 /* 空载延迟测试的消息数 */
+#define LAT_SAMPLE_SHIFT (6)	 /* 吞吐量测试中每 2^6 条消息采样一次延迟 */
+
+/**
+ * @brief 测试消息 16字节
+ */
+struct msg {
+	uint32_t seq;
+	uint32_t pad;
+	uint64_t ts; // 发送时间 纳秒
+};
+
+/**
+ * @brief 一次双线程测试的参数与结果
+ */
+struct run {
+	uint32_t num;		// 消息数
+	bool batch;			// 按批发送, 否则每次等邮箱读空后发送一条(空载延迟)
+	uint64_t *lat;		// 延迟采样
+	uint32_t lat_num;	// 延迟采样数
+	uint32_t bad;		// 顺序错误的消息数
+};
+
+static struct mailbox mb;
+static struct msg buf[MB_UNITS];
+static int ncpu;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void pin(int cpu)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// 只有1个CPU时靠让出切换到对端
+static inline void relax(void)
+{
+	if (ncpu == 1)
+		sched_yield();
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void *producer(void *arg)
+{
+	struct run *r = arg;
+	struct msg m[BATCH] = { 0 };
+
+	pin(0);
+	for (uint32_t i = 0; i < r->num;) {
+		uint32_t k = 0;
+
+		if (r->batch) {
+			for (; k < BATCH && i + k < r->num; k++)
+				m[k].seq = i + k;
+		} else {
+			while (mailbox_used(&mb))
+				relax();
+			m[k++].seq = i;
+		}
+
+		uint64_t ts = now_ns();
+		for (uint32_t j = 0; j < k; j++)
+			m[j].ts = ts;
+
+		uint32_t sent = mailbox_post(&mb, m, k);
+		i += sent;
+		if (sent < k) {
+			// 未发出的消息下一轮按新的序号重新填写
+			relax();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief 发送端与接收端分别运行在 CPU0 与 CPU1(只有1个CPU时运行在同一个CPU上)
+ *
+ * @param r 测试参数与结果
+ * @return double 耗时 秒
+ */
+static double run_pair(struct run *r)
+{
+	pthread_t t;
+	struct msg m[BATCH];
+	uint32_t expect = 0;
+
+	mailbox_init(&mb, buf, sizeof(struct msg), MB_UNITS);
+	r->bad = 0;
+	r->lat_num = 0;
+
+	uint64_t t0 = now_ns();
+	if (pthread_create(&t, NULL, producer, r))
+		return 0;
+	pin(ncpu > 1);
+
+	while (expect < r->num) {
+		size_t n = mailbox_fetch(&mb, m, BATCH);
+		if (!n) {
+			relax();
+			continue;
+		}
+
+		uint64_t now = now_ns();
+		for (size_t i = 0; i < n; i++) {
+			if (r->batch ? !(expect & ((1u << LAT_SAMPLE_SHIFT) - 1)) : true)
+				r->lat[r->lat_num++] = now - m[i].ts;
+			r->bad += m[i].seq != expect++;
+		}
+	}
+	pthread_join(t, NULL);
+
+	return (now_ns() - t0) / 1e9;
+}
+
+static void print_lat(const char *name, struct run *r)
+{
+	qsort(r->lat, r->lat_num, sizeof(uint64_t), cmp_u64);
+	printf("%s: latency p50 %llu ns, p99 %llu ns\n", name, (unsigned long long)r->lat[r->lat_num / 2],
+		(unsigned long long)r->lat[r->lat_num - r->lat_num / 100 - 1]);
+}
+
+/**
+ * @brief 单线程收发 每次 batch 条, 返回每条消息的耗时(纳秒)
+ */
+static double run_single(uint32_t num, uint32_t batch)
+{
+	struct msg m[BATCH] = { 0 };
+	uint32_t bad = 0;
+
+	mailbox_init(&mb, buf, sizeof(struct msg), MB_UNITS);
+
+	uint64_t t0 = now_ns();
+	for (uint32_t i = 0; i < num; i += batch) {
+		for (uint32_t k = 0; k < batch; k++)
+			m[k].seq = i + k;
+		mailbox_post(&mb, m, batch);
+		mailbox_fetch(&mb, m, batch);
+		bad += m[0].seq != i;
+	}
+	uint64_t cost = now_ns() - t0;
+
+	return bad ? -1 : (double)cost / num;
+}
+
+/**
+ * @brief 参数为吞吐量测试的消息数 默认 THROUGHPUT_MSGS
+ */
+int main(int argc, char *argv[])
+{
+	uint32_t num = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : THROUGHPUT_MSGS;
+	struct run tp = { .num = num, .batch = true };
+	struct run lat = { .num = num < LATENCY_MSGS ? num : LATENCY_MSGS };
+
+	if (!num)
+		return EXIT_FAILURE;
+
+	ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+	tp.lat = malloc(sizeof(uint64_t) * ((num >> LAT_SAMPLE_SHIFT) + 1));
+	lat.lat = malloc(sizeof(uint64_t) * lat.num);
+	if (!tp.lat || !lat.lat)
+		return EXIT_FAILURE;
+
+	printf("cpus %d, message %zu bytes\n", ncpu, sizeof(struct msg));
+	printf("single thread, 1 per call: %.1f ns/msg\n", run_single(num, 1));
+	printf("single thread, %d per call: %.1f ns/msg\n", BATCH, run_single(num, BATCH));
+
+	double s = run_pair(&tp);
+	printf("two threads, %d per call: %.1f Mmsg/s, bad %u\n", BATCH, tp.num / s / 1e6, tp.bad);
+	print_lat("two threads, loaded", &tp);
+
+	run_pair(&lat);
+	printf("two threads, one at a time: bad %u\n", lat.bad);
+	print_lat("two threads, unloaded", &lat);
+
+	int ret = (tp.bad || lat.bad) ? EXIT_FAILURE : EXIT_SUCCESS;
+	free(tp.lat);
+	free(lat.lat);
+	return ret;
+}
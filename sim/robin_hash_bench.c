@@ -0,0 +1,127 @@
+/**
+ * @file robin_hash_bench.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 开放寻址哈希表与链式哈希表的主机性能对比
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ *
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils/robin_hash.h"
+#include "utils/string_hash.h"
+
+#define KEY_LEN (24)		  /* 键缓冲区长度 */
+#define OPS_PER_SIZE (200000) /* 每种键数下每项操作的总次数 */
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/**
+ * @brief 比较插入、命中查找与未命中查找的耗时
+ *
+ * string_hash 按头文件建议使用键数2倍的桶, robin_hash 按键数初始化容量;
+ * 查找结果与插入的数据不符时返回失败
+ */
+int main(void)
+{
+	static const int sizes[] = { 10, 100, 1000, 10000 };
+	int bad = 0;
+
+	printf("%6s %8s %8s %8s %8s %8s %8s\n", "keys", "ins_old", "ins_rh", "hit_old", "hit_rh", "miss_old", "miss_rh");
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		int n = sizes[s], rounds = OPS_PER_SIZE / n + 1;
+		char(*keys)[KEY_LEN] = malloc((size_t)n * KEY_LEN);
+		char(*miss)[KEY_LEN] = malloc((size_t)n * KEY_LEN);
+		double r[6] = { 0 };
+
+		if (!keys || !miss)
+			return EXIT_FAILURE;
+
+		for (int i = 0; i < n; i++) {
+			snprintf(keys[i], KEY_LEN, "dev_%d_x", i);
+			snprintf(miss[i], KEY_LEN, "nod_%d_y", i);
+		}
+
+		for (int k = 0; k < rounds; k++) {
+			struct hash_table old;
+			struct robin_hash rh;
+
+			uint64_t t0 = now_ns();
+			init_hash_table(&old, n * 2);
+			for (int i = 0; i < n; i++)
+				hash_insert(&old, keys[i], keys[i]);
+			r[0] += now_ns() - t0;
+
+			t0 = now_ns();
+			robin_hash_init(&rh, n);
+			for (int i = 0; i < n; i++)
+				robin_hash_insert(&rh, keys[i], keys[i]);
+			r[1] += now_ns() - t0;
+
+			t0 = now_ns();
+			for (int i = 0; i < n; i++)
+				bad += hash_find(&old, keys[i], NULL) != keys[i];
+			r[2] += now_ns() - t0;
+
+			t0 = now_ns();
+			for (int i = 0; i < n; i++)
+				bad += robin_hash_find(&rh, keys[i], NULL) != keys[i];
+			r[3] += now_ns() - t0;
+
+			t0 = now_ns();
+			for (int i = 0; i < n; i++)
+				bad += hash_find(&old, miss[i], NULL) != NULL;
+			r[4] += now_ns() - t0;
+
+			t0 = now_ns();
+			for (int i = 0; i < n; i++)
+				bad += robin_hash_find(&rh, miss[i], NULL) != NULL;
+			r[5] += now_ns() - t0;
+
+			destroy_hash_table(&old);
+			robin_hash_destroy(&rh);
+		}
+
+		double ops = (double)rounds * n;
+		printf("%6d %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n", n, r[0] / ops, r[1] / ops, r[2] / ops, r[3] / ops,
+			r[4] / ops, r[5] / ops);
+		free(keys);
+		free(miss);
+	}
+
+	printf("%s\n", bad ? "FAIL" : "PASS");
+	return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
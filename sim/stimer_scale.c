@@ -0,0 +1,204 @@
+/**
+ * @file stimer_scale.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 多实例仿真的吞吐量与线程数的关系
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ *
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "utils/stimer.h"
+
+#define NODE_NUM (200)		/* 节点数 */
+#define TASK_PER_NODE (10)	/* 每个节点的周期任务数 */
+#define SIM_TICKS (100000)	/* 每个节点推进的节拍数 */
+#define STEP_TICKS (100)	/* 各节点交替推进的节拍数 模拟同步运行 */
+#define MAX_THREAD (64)		/* 最大线程数 */
+#define CACHE_LINE (64)		/* 缓存行大小 */
+
+/**
+ * @brief 线程的执行计数 独占一个缓存行, 避免线程之间的伪共享
+ */
+struct counter {
+	_Alignas(CACHE_LINE) unsigned long runs;
+};
+
+/**
+ * @brief 线程负责的节点范围
+ */
+struct range {
+	int begin;
+	int end;
+	struct counter *cnt;
+};
+
+static struct stimer_ctx *nodes[NODE_NUM];
+static struct counter counters[MAX_THREAD];
+static _Thread_local struct counter *self_cnt; // 当前线程的计数
+
+static void node_task(void)
+{
+	self_cnt->runs++;
+}
+
+static void *run_nodes(void *arg)
+{
+	struct range *r = arg;
+
+	self_cnt = r->cnt;
+	for (uint32_t t = 0; t < SIM_TICKS; t += STEP_TICKS) {
+		for (int i = r->begin; i < r->end; i++)
+			stimer_ctx_step(nodes[i], STEP_TICKS);
+	}
+	return NULL;
+}
+
+static double now_s(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 创建全部节点, 每次测量使用新的节点, 各次的任务释放序列相同
+ */
+static bool nodes_create(void)
+{
+	static const uint32_t periods[TASK_PER_NODE] = { 1, 2, 5, 10, 10, 20, 50, 100, 500, 1000 };
+
+	for (int i = 0; i < NODE_NUM; i++) {
+		nodes[i] = stimer_ctx_create();
+		if (!nodes[i])
+			return false;
+
+		for (int k = 0; k < TASK_PER_NODE; k++) {
+			struct stimer_task_attr attr = { .task_f = node_task, .period_ms = periods[k] };
+			if (!stimer_ctx_task_create(nodes[i], &attr))
+				return false;
+		}
+	}
+	return true;
+}
+
+static void nodes_destroy(void)
+{
+	for (int i = 0; i < NODE_NUM; i++) {
+		stimer_ctx_destroy(nodes[i]);
+		nodes[i] = NULL;
+	}
+}
+
+/**
+ * @brief 按线程数平均分配节点并推进 SIM_TICKS 个节拍
+ *
+ * @param nthread 线程数
+ * @param runs 输出全部任务的执行次数
+ * @return double 吞吐量 百万节点节拍/秒, 失败返回0
+ */
+static double scale_run(int nthread, unsigned long *runs)
+{
+	pthread_t th[MAX_THREAD];
+	struct range r[MAX_THREAD];
+	int started = 0;
+
+	if (!nodes_create()) {
+		nodes_destroy();
+		return 0;
+	}
+
+	double start = now_s();
+	for (int t = 0; t < nthread; t++) {
+		counters[t].runs = 0;
+		r[t] = (struct range){ NODE_NUM * t / nthread, NODE_NUM * (t + 1) / nthread, &counters[t] };
+		if (pthread_create(&th[t], NULL, run_nodes, &r[t]))
+			break;
+		++started;
+	}
+	for (int t = 0; t < started; t++)
+		pthread_join(th[t], NULL);
+	double cost = now_s() - start;
+
+	nodes_destroy();
+	if (started != nthread)
+		return 0;
+
+	*runs = 0;
+	for (int t = 0; t < nthread; t++)
+		*runs += counters[t].runs;
+
+	return (double)NODE_NUM * SIM_TICKS / cost / 1e6;
+}
+
+/**
+ * @brief 依次测量命令行指定的线程数 不指定时测量 1, 2, 4 ... MAX_THREAD 中不超过处理器数的值
+ *
+ * 线程数限制在 [1, MAX_THREAD], 各次测量的任务执行总次数必须相同
+ */
+int main(int argc, char *argv[])
+{
+	int list[MAX_THREAD];
+	int num = 0;
+	unsigned long expect = 0;
+	double base = 0;
+
+	if (argc > 1) {
+		for (int k = 1; k < argc && num < MAX_THREAD; k++) {
+			int n = atoi(argv[k]);
+			list[num++] = n < 1 ? 1 : (n > MAX_THREAD ? MAX_THREAD : n);
+		}
+	} else {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		for (int n = 1; n <= MAX_THREAD && (n == 1 || n <= cpus); n *= 2)
+			list[num++] = n;
+	}
+
+	for (int k = 0; k < num; k++) {
+		unsigned long runs = 0;
+		double mps = scale_run(list[k], &runs);
+
+		if (mps == 0 || (k && runs != expect)) {
+			printf("threads %2d: FAILED\n", list[k]);
+			return EXIT_FAILURE;
+		}
+
+		if (!k) {
+			expect = runs;
+			base = mps;
+		}
+		printf("threads %2d: %.2f M node-ticks/s, speedup %.2f\n", list[k], mps, mps / base);
+	}
+
+	return EXIT_SUCCESS;
+}
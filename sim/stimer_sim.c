@@ -0,0 +1,291 @@
+/**
+ * @file stimer_sim.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 调度组件的虚拟时间仿真
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "stimer_sim.h"
+
+#define STIMER_SIM_MAX_TASK (32) // 单个仿真中最多跟踪的任务数
+
+// 单个任务的统计
+struct stimer_sim_slot {
+	stimer_handle task;
+	uint32_t deadline; // 相对截止时间 单位节拍 为0时不检查
+	uint32_t release;  // 最近一次名义释放节拍
+	uint32_t releases;
+	uint32_t runs;
+	uint32_t misses;
+	uint32_t latency_min;
+	uint32_t latency_max;
+	uint64_t latency_sum;
+};
+
+struct stimer_sim {
+	struct stimer_ctx *ctx;
+	struct stimer_sim_slot slots[STIMER_SIM_MAX_TASK];
+	size_t slot_num;
+
+	struct stimer_sim_trace *trace; // 原始跟踪环形缓冲 可为NULL
+	size_t trace_len;
+	size_t trace_head; // 最早一条记录的位置
+	size_t trace_cnt;
+};
+
+/**
+ * @brief 毫秒转换为节拍数
+ * 
+ * @param ms 毫秒
+ * @return uint32_t 节拍数
+ */
+static uint32_t stimer_sim_ms_to_tick(uint32_t ms)
+{
+	return (uint32_t)((uint64_t)ms * 1000 / STIMER_TICK_US);
+}
+
+/**
+ * @brief 查找任务对应的统计
+ * 
+ * @param sim 仿真
+ * @param task 任务句柄
+ * @return struct stimer_sim_slot* 找不到时返回NULL
+ */
+static struct stimer_sim_slot *stimer_sim_find(struct stimer_sim *sim, stimer_handle task)
+{
+	for (size_t i = 0; i < sim->slot_num; i++) {
+		if (sim->slots[i].task == task)
+			return &sim->slots[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 保存一条原始跟踪记录 写满后覆盖最早的记录
+ * 
+ * @param sim 仿真
+ * @param task 任务句柄
+ * @param ev 事件
+ * @param tick 节拍
+ */
+static void stimer_sim_record(struct stimer_sim *sim, stimer_handle task, enum stimer_trace_event ev, uint32_t tick)
+{
+	size_t pos;
+
+	if (!sim->trace)
+		return;
+
+	if (sim->trace_cnt < sim->trace_len) {
+		pos = (sim->trace_head + sim->trace_cnt) % sim->trace_len;
+		++sim->trace_cnt;
+	} else {
+		pos = sim->trace_head;
+		sim->trace_head = (sim->trace_head + 1) % sim->trace_len;
+	}
+
+	sim->trace[pos].tick = tick;
+	sim->trace[pos].task = task;
+	sim->trace[pos].ev = ev;
+}
+
+/**
+ * @brief 调度器实例的跟踪函数
+ */
+static void stimer_sim_trace_cb(void *arg, struct stimer_task *task, enum stimer_trace_event ev, uint32_t tick)
+{
+	struct stimer_sim *sim = (struct stimer_sim *)arg;
+	struct stimer_sim_slot *slot = stimer_sim_find(sim, task);
+
+	stimer_sim_record(sim, task, ev, tick);
+
+	if (!slot)
+		return;
+
+	switch (ev) {
+	case STIMER_TRACE_RELEASE:
+		slot->release = tick;
+		++slot->releases;
+		break;
+
+	case STIMER_TRACE_START: {
+		// 事件任务没有周期释放, 以开始执行作为释放
+		if (!slot->releases)
+			slot->release = tick;
+
+		uint32_t latency = tick - slot->release;
+		if (!slot->runs || latency < slot->latency_min)
+			slot->latency_min = latency;
+		if (latency > slot->latency_max)
+			slot->latency_max = latency;
+		slot->latency_sum += latency;
+		++slot->runs;
+		break;
+	}
+
+	case STIMER_TRACE_END:
+		if (slot->deadline && tick - slot->release > slot->deadline)
+			++slot->misses;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/************************************EXPOSE API************************************/
+
+stimer_sim_handle stimer_sim_create(size_t trace_len)
+{
+	struct stimer_sim *sim = calloc(1, sizeof(struct stimer_sim));
+	if (!sim)
+		return NULL;
+
+	if (trace_len) {
+		sim->trace = calloc(trace_len, sizeof(struct stimer_sim_trace));
+		if (!sim->trace)
+			goto err;
+		sim->trace_len = trace_len;
+	}
+
+	sim->ctx = stimer_ctx_create();
+	if (!sim->ctx)
+		goto err;
+
+	stimer_ctx_set_trace(sim->ctx, stimer_sim_trace_cb, sim);
+
+	return sim;
+
+err:
+	free(sim->trace);
+	free(sim);
+	return NULL;
+}
+
+void stimer_sim_destroy(stimer_sim_handle sim)
+{
+	if (!sim)
+		return;
+
+	stimer_ctx_destroy(sim->ctx);
+	free(sim->trace);
+	free(sim);
+}
+
+stimer_handle stimer_sim_task_create(stimer_sim_handle sim, const struct stimer_task_attr *attr)
+{
+	if (!sim || !attr || sim->slot_num >= STIMER_SIM_MAX_TASK)
+		return NULL;
+
+	stimer_handle task = stimer_ctx_task_create(sim->ctx, attr);
+	if (!task)
+		return NULL;
+
+	struct stimer_sim_slot *slot = &sim->slots[sim->slot_num++];
+	memset(slot, 0, sizeof(struct stimer_sim_slot));
+	slot->task = task;
+
+	// 截止时间按创建时的参数换算, 运行中修改周期不影响判定
+	if (attr->deadline_ms)
+		slot->deadline = stimer_sim_ms_to_tick(attr->deadline_ms);
+	else if (attr->period_us)
+		slot->deadline = attr->period_us / STIMER_TICK_US;
+	else
+		slot->deadline = stimer_sim_ms_to_tick(attr->period_ms);
+
+	return task;
+}
+
+void stimer_sim_run(stimer_sim_handle sim, uint32_t ticks)
+{
+	if (sim)
+		stimer_ctx_step(sim->ctx, ticks);
+}
+
+void stimer_sim_consume(stimer_sim_handle sim, uint32_t ticks)
+{
+	if (sim)
+		stimer_ctx_advance(sim->ctx, ticks);
+}
+
+uint32_t stimer_sim_get_tick(stimer_sim_handle sim)
+{
+	return sim ? stimer_ctx_get_tick(sim->ctx) : 0;
+}
+
+struct stimer_ctx *stimer_sim_get_ctx(stimer_sim_handle sim)
+{
+	return sim ? sim->ctx : NULL;
+}
+
+bool stimer_sim_get_report(stimer_sim_handle sim, stimer_handle task, struct stimer_sim_report *report)
+{
+	struct stimer_sim_slot *slot;
+	struct stimer_task_stat stat;
+
+	if (!sim || !report)
+		return false;
+
+	slot = stimer_sim_find(sim, task);
+	if (!slot)
+		return false;
+
+	memset(report, 0, sizeof(struct stimer_sim_report));
+	if (stimer_task_get_stat(task, &stat))
+		report->lost = stat.lost;
+
+	report->releases = slot->releases;
+	report->runs = slot->runs;
+	report->misses = slot->misses;
+	if (slot->runs) {
+		report->latency_min = slot->latency_min;
+		report->latency_max = slot->latency_max;
+		report->latency_avg = (uint32_t)(slot->latency_sum / slot->runs);
+		report->jitter = slot->latency_max - slot->latency_min;
+	}
+
+	return true;
+}
+
+size_t stimer_sim_read_trace(stimer_sim_handle sim, struct stimer_sim_trace *buf, size_t num)
+{
+	size_t n = 0;
+
+	if (!sim || !buf)
+		return 0;
+
+	while (n < num && sim->trace_cnt) {
+		buf[n++] = sim->trace[sim->trace_head];
+		sim->trace_head = (sim->trace_head + 1) % sim->trace_len;
+		--sim->trace_cnt;
+	}
+
+	return n;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file stimer_sim.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 调度组件的虚拟时间仿真
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_STIMER_SIM_H__
+#define __VIRTUAL_OS_STIMER_SIM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "utils/stimer.h"
+
+/**
+ * 虚拟时间仿真
+ * 
+ * 在主机上以同步注入节拍的方式驱动一个调度器实例, 不经过真实时间, 结果只取决于输入, 可以重复:
+ * - 节拍由 stimer_sim_run 注入, 每个节拍依次执行快速任务、投递的工作与到期的任务
+ * - 任务中调用 stimer_sim_consume 模拟执行时间, 期间经过的节拍会推迟同一节拍及之后到期的任务
+ * - 记录每个任务的释放、开始与结束事件, 统计释放延迟、抖动与截止时间错过次数, 可选保存原始事件
+ */
+
+typedef struct stimer_sim *stimer_sim_handle;
+
+/**
+ * @brief 原始跟踪记录
+ */
+struct stimer_sim_trace {
+	uint32_t tick;				/* 事件发生的节拍 */
+	stimer_handle task;			/* 任务句柄 */
+	enum stimer_trace_event ev; /* 事件 */
+};
+
+/**
+ * @brief 任务的仿真统计 时间单位均为节拍
+ * 
+ * 释放延迟为名义释放节拍到开始执行的节拍数, 抖动为最大与最小释放延迟之差
+ * 执行结束时距离名义释放节拍超过相对截止时间(未设置时为周期)即计为一次错过
+ */
+struct stimer_sim_report {
+	uint32_t releases;	  /* 周期释放次数 */
+	uint32_t runs;		  /* 执行次数 */
+	uint32_t lost;		  /* 因跳过或合并而未执行的释放次数 */
+	uint32_t misses;	  /* 错过截止时间的次数 */
+	uint32_t latency_min; /* 最小释放延迟 */
+	uint32_t latency_max; /* 最大释放延迟 */
+	uint32_t latency_avg; /* 平均释放延迟 */
+	uint32_t jitter;	  /* 释放抖动 */
+};
+
+/**
+ * @brief 创建仿真
+ * 
+ * @param trace_len 保存的原始跟踪记录条数, 写满后覆盖最早的记录, 为0时只统计
+ * @return stimer_sim_handle 成功返回句柄，失败返回NULL
+ */
+stimer_sim_handle stimer_sim_create(size_t trace_len);
+
+/**
+ * @brief 销毁仿真, 同时销毁其中的任务
+ * 
+ * @param sim 仿真句柄
+ */
+void stimer_sim_destroy(stimer_sim_handle sim);
+
+/**
+ * @brief 在仿真中按参数创建任务
+ * 
+ * @param sim 仿真句柄
+ * @param attr 任务参数
+ * @return stimer_handle 成功返回任务句柄，失败返回NULL
+ */
+stimer_handle stimer_sim_task_create(stimer_sim_handle sim, const struct stimer_task_attr *attr);
+
+/**
+ * @brief 注入指定数量的节拍
+ * 
+ * @param sim 仿真句柄
+ * @param ticks 节拍数
+ */
+void stimer_sim_run(stimer_sim_handle sim, uint32_t ticks);
+
+/**
+ * @brief 在任务中调用, 模拟任务执行了指定的节拍数
+ * 
+ * @param sim 仿真句柄
+ * @param ticks 节拍数
+ */
+void stimer_sim_consume(stimer_sim_handle sim, uint32_t ticks);
+
+/**
+ * @brief 获取仿真的当前节拍
+ * 
+ * @param sim 仿真句柄
+ * @return uint32_t 当前节拍
+ */
+uint32_t stimer_sim_get_tick(stimer_sim_handle sim);
+
+/**
+ * @brief 获取仿真使用的调度器实例, 用于直接调用实例接口
+ * 
+ * @param sim 仿真句柄
+ * @return struct stimer_ctx* 调度器实例
+ */
+struct stimer_ctx *stimer_sim_get_ctx(stimer_sim_handle sim);
+
+/**
+ * @brief 获取任务的仿真统计
+ * 
+ * @param sim 仿真句柄
+ * @param task 任务句柄
+ * @param report 输出统计
+ * @return bool 成功返回true, 任务不属于该仿真返回false
+ */
+bool stimer_sim_get_report(stimer_sim_handle sim, stimer_handle task, struct stimer_sim_report *report);
+
+/**
+ * @brief 按时间顺序读出保存的原始跟踪记录, 读出后清空
+ * 
+ * @param sim 仿真句柄
+ * @param buf 输出缓冲
+ * @param num 缓冲可容纳的记录条数
+ * @return size_t 实际读出的条数
+ */
+size_t stimer_sim_read_trace(stimer_sim_handle sim, struct stimer_sim_trace *buf, size_t num);
+
+#endif /* __VIRTUAL_OS_STIMER_SIM_H__ */
@@ -0,0 +1,369 @@
+/**
+ * @file stimer_sim_main.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 调度组件的主机仿真场景
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "stimer_sim.h"
+
+/**
+ * @brief 仿真场景
+ */
+struct sim_scenario {
+	const char *name;  // 场景名 命令行参数
+	bool (*run)(void); // 执行场景 结果不符合预期时返回false
+};
+
+static stimer_sim_handle sim = NULL;
+
+/**
+ * @brief 主机单调时钟
+ * 
+ * @return double 秒
+ */
+static double sim_now_s(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************************EXAMPLE************************************/
+
+static void ctrl_task(void)
+{
+	stimer_sim_consume(sim, 3); // 执行3个节拍
+}
+
+static void comm_task(void)
+{
+	stimer_sim_consume(sim, 4);
+}
+
+static void led_task(void)
+{
+}
+
+/**
+ * @brief 文档中的示例: 高优先级任务推迟同一节拍释放的其他任务
+ */
+static bool scenario_example(void)
+{
+	struct stimer_task_attr ctrl = { .name = "ctrl", .task_f = ctrl_task, .period_ms = 5, .no_stagger = true };
+	struct stimer_task_attr comm = {
+		.name = "comm", .task_f = comm_task, .period_ms = 10, .priority = 1, .no_stagger = true
+	};
+	struct stimer_task_attr led = {
+		.name = "led", .task_f = led_task, .period_ms = 10, .deadline_ms = 2, .no_stagger = true
+	};
+	struct stimer_sim_report r[3];
+	stimer_handle tasks[3];
+
+	sim = stimer_sim_create(0);
+	if (!sim)
+		return false;
+
+	tasks[0] = stimer_sim_task_create(sim, &ctrl);
+	tasks[1] = stimer_sim_task_create(sim, &comm);
+	tasks[2] = stimer_sim_task_create(sim, &led);
+
+	stimer_sim_run(sim, 1000);
+
+	for (int i = 0; i < 3; i++) {
+		stimer_sim_get_report(sim, tasks[i], &r[i]);
+		printf("  %-5s runs %u miss %u latency %u/%u/%u jitter %u\n", stimer_task_name(tasks[i]), r[i].runs,
+			r[i].misses, r[i].latency_min, r[i].latency_avg, r[i].latency_max, r[i].jitter);
+	}
+
+	stimer_sim_destroy(sim);
+	sim = NULL;
+
+	// comm 不受其他任务影响, led 每次都被 comm 推迟4个节拍
+	return r[1].misses == 0 && r[1].jitter == 0 && r[2].latency_min == 4 && r[2].misses == r[2].runs;
+}
+
+/************************************THROUGHPUT************************************/
+
+static void empty_task(void)
+{
+}
+
+/**
+ * @brief 16个空任务时每秒推进的节拍数
+ */
+static bool scenario_throughput(void)
+{
+	static const uint32_t periods[] = { 1, 2, 5, 10, 20, 50, 100, 1000 };
+	const uint32_t ticks = 2000000;
+
+	sim = stimer_sim_create(0);
+	if (!sim)
+		return false;
+
+	for (int i = 0; i < 16; i++) {
+		struct stimer_task_attr attr = { .task_f = empty_task, .period_ms = periods[i % 8] };
+		stimer_sim_task_create(sim, &attr);
+	}
+
+	double start = sim_now_s();
+	stimer_sim_run(sim, ticks);
+	double cost = sim_now_s() - start;
+
+	printf("  16 tasks: %.2f M ticks/s\n", ticks / cost / 1e6);
+
+	bool ok = stimer_sim_get_tick(sim) == ticks;
+	stimer_sim_destroy(sim);
+	sim = NULL;
+	return ok;
+}
+
+/************************************WHEEL************************************/
+
+#define WHEEL_SAMPLES (65536) // 逐节拍计时的采样数 覆盖两个第3级槽位的级联节拍
+#define WHEEL_PASSES (5)	  // 重复次数 每个节拍取最小值, 排除主机偶发的调度抖动
+
+static int cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+static uint32_t wheel_runs = 0; // 当前节拍的任务执行次数
+
+static void wheel_task(void)
+{
+	++wheel_runs;
+}
+
+/**
+ * @brief 创建时间轮场景并运行到计时的起点
+ * 
+ * @param count 任务数
+ * @return bool 
+ */
+static bool wheel_setup(uint32_t count)
+{
+	uint32_t seed = count;
+
+	sim = stimer_sim_create(0);
+	if (!sim)
+		return false;
+
+	struct stimer_ctx *ctx = stimer_sim_get_ctx(sim);
+	for (uint32_t i = 0; i < count; i++) {
+		seed = seed * 1103515245 + 12345;
+		struct stimer_task_attr attr = { .task_f = wheel_task, .period_ms = 1000 + (seed >> 8) % 59001, .no_stagger = true };
+		if (i < 4)
+			attr.period_ms = 1 + i * 3;
+		if (!stimer_ctx_task_create(ctx, &attr))
+			return false;
+	}
+
+	stimer_sim_run(sim, 60000);
+	return true;
+}
+
+/**
+ * @brief 每节拍调度开销与任务数的关系
+ * 
+ * 任务周期在1s~60s之间伪随机分布, 另有4个1ms~10ms的短周期任务, 周期已经分散相位, 不再错开相位(错开相位的
+ * 创建开销与任务数的平方成正比, 不是这里要测量的), 先运行一个最长周期使相位分布稳定, 再统计平均每节拍耗时,
+ * 以及逐节拍计时的 99.9 分位与最大值
+ * 逐节拍计时重复 WHEEL_PASSES 次(任务集与节拍序列相同), 每个节拍取最小值, 排除主机的调度抖动,
+ * 保留级联等确定出现在某个节拍上的开销
+ * 
+ * 每个节拍的开销与该节拍到期和级联的任务数成正比, 与总任务数无关; 总任务数增加时每个节拍到期的任务变多,
+ * 99.9 分位与最大值随之增长, 因此同时输出每节拍平均与最多的执行次数, 只检查:
+ * 1. 平均每节拍耗时不超过10个任务时的 WHEEL_AVG_LIMIT 倍
+ * 2. 最大值不超过同一任务数下 99.9 分位的 WHEEL_SPIKE_LIMIT 倍, 即没有个别节拍(例如一次级联整个高级槽位)远超其他节拍
+ */
+#define WHEEL_AVG_LIMIT (3)
+#define WHEEL_SPIKE_LIMIT (5)
+
+static bool scenario_wheel(void)
+{
+	static double samples[WHEEL_SAMPLES];
+	static const uint32_t counts[] = { 10, 100, 1000, 10000 };
+	const uint32_t ticks = 600000;
+	double base_avg = 0;
+	bool ok = true;
+
+	for (size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); n++) {
+		double avg = 0;
+		uint32_t runs_max = 0;
+		uint64_t runs_sum = 0;
+
+		for (uint32_t pass = 0; pass < WHEEL_PASSES; pass++) {
+			if (!wheel_setup(counts[n])) {
+				stimer_sim_destroy(sim);
+				sim = NULL;
+				return false;
+			}
+
+			double start;
+			if (!pass) {
+				start = sim_now_s();
+				stimer_sim_run(sim, ticks);
+				avg = (sim_now_s() - start) / ticks;
+			} else {
+				stimer_sim_run(sim, ticks);
+			}
+
+			for (uint32_t i = 0; i < WHEEL_SAMPLES; i++) {
+				wheel_runs = 0;
+				start = sim_now_s();
+				stimer_sim_run(sim, 1);
+				double t = sim_now_s() - start;
+				if (!pass || t < samples[i])
+					samples[i] = t;
+				if (!pass) {
+					runs_sum += wheel_runs;
+					if (wheel_runs > runs_max)
+						runs_max = wheel_runs;
+				}
+			}
+
+			ok &= stimer_sim_get_tick(sim) == 60000 + ticks + WHEEL_SAMPLES;
+			stimer_sim_destroy(sim);
+			sim = NULL;
+		}
+
+		qsort(samples, WHEEL_SAMPLES, sizeof(double), cmp_double);
+
+		double p999 = samples[WHEEL_SAMPLES - WHEEL_SAMPLES / 1000];
+		double max = samples[WHEEL_SAMPLES - 1];
+		printf("  %5u tasks: avg %.0f ns/tick, p99.9 %.0f ns/tick, max %.0f ns/tick, runs/tick avg %.2f max %u\n",
+			counts[n], avg * 1e9, p999 * 1e9, max * 1e9, (double)runs_sum / WHEEL_SAMPLES, runs_max);
+
+		if (!n)
+			base_avg = avg;
+		if (avg > base_avg * WHEEL_AVG_LIMIT || max > p999 * WHEEL_SPIKE_LIMIT)
+			ok = false;
+	}
+
+	return ok;
+}
+
+/************************************PRIORITY************************************/
+
+static void busy_task(void)
+{
+	stimer_sim_consume(sim, 1);
+}
+
+/**
+ * @brief 控制任务与8个同节拍释放的后台任务共同运行, 返回控制任务的统计
+ * 
+ * 后台任务周期20ms, 各执行1个节拍, 全部对齐在同一节拍释放; 控制任务最后创建
+ * 
+ * @param period_ms 控制任务的周期
+ * @param prio 控制任务的优先级
+ * @param deadline_ms 控制任务的截止时间 为20时与后台任务的绝对截止时间相同, 即退化为FIFO
+ * @param r 控制任务的统计
+ */
+static bool priority_run(uint32_t period_ms, uint8_t prio, uint32_t deadline_ms, struct stimer_sim_report *r)
+{
+	struct stimer_task_attr attr = { .task_f = busy_task, .period_ms = 20, .no_stagger = true };
+	struct stimer_task_attr ctrl = {
+		.task_f = empty_task, .period_ms = period_ms, .priority = prio, .deadline_ms = deadline_ms, .no_stagger = true
+	};
+
+	sim = stimer_sim_create(0);
+	if (!sim)
+		return false;
+
+	for (int i = 0; i < 8; i++)
+		stimer_sim_task_create(sim, &attr);
+	stimer_handle task = stimer_sim_task_create(sim, &ctrl);
+
+	stimer_sim_run(sim, 20000);
+
+	bool ok = task && stimer_sim_get_report(sim, task, r);
+	stimer_sim_destroy(sim);
+	sim = NULL;
+	return ok;
+}
+
+/**
+ * @brief 同一节拍释放时控制任务的最坏派发延迟(节拍)
+ * 
+ * 控制任务周期20ms时与后台任务每次都在同一节拍释放, 分别按FIFO、高优先级、更早截止时间(EDF)
+ * 三种方式比较; 周期1ms时另外给出非抢占调度下的延迟上界, 即一个节拍内全部到期任务的执行时间
+ */
+static bool scenario_priority(void)
+{
+	struct stimer_sim_report fifo, prio, edf, fast;
+
+	if (!priority_run(20, 0, 20, &fifo) || !priority_run(20, 1, 20, &prio) || !priority_run(20, 0, 2, &edf) ||
+		!priority_run(1, 1, 0, &fast))
+		return false;
+
+	printf("  fifo   : latency max %u miss %u/%u\n", fifo.latency_max, fifo.misses, fifo.runs);
+	printf("  prio   : latency max %u miss %u/%u\n", prio.latency_max, prio.misses, prio.runs);
+	printf("  edf    : latency max %u miss %u/%u\n", edf.latency_max, edf.misses, edf.runs);
+	printf("  prio1ms: latency max %u avg %u\n", fast.latency_max, fast.latency_avg);
+
+	return fifo.latency_max == 8 && prio.latency_max == 0 && edf.latency_max == 0;
+}
+
+static const struct sim_scenario scenarios[] = {
+	{ "example", scenario_example },
+	{ "throughput", scenario_throughput },
+	{ "wheel", scenario_wheel },
+	{ "priority", scenario_priority },
+};
+
+/**
+ * @brief 执行命令行指定的场景 不指定时执行全部场景
+ */
+int main(int argc, char *argv[])
+{
+	int failed = 0;
+
+	for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+		bool selected = argc < 2;
+		for (int k = 1; k < argc; k++)
+			selected |= strcmp(argv[k], scenarios[i].name) == 0;
+		if (!selected)
+			continue;
+
+		printf("[%s]\n", scenarios[i].name);
+		if (!scenarios[i].run()) {
+			printf("  FAILED\n");
+			++failed;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file stimer_tickless.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 无节拍模式的主机验证 用 timerfd 模拟节拍定时器, 用线程模拟中断投递
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ *
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include "utils/stimer.h"
+
+#define REPORT_ROUNDS (3)		/* 统计的秒数 */
+#define WAKEUP_LIMIT (100)		/* 每秒唤醒次数上限 周期节拍模式下约为每秒节拍数 */
+#define IRQ_PERIOD_US (97000)	/* 模拟中断的投递间隔 与任务周期错开 */
+#define IRQ_LATENCY_MAX_US (20000) /* 投递到事件任务执行的最长延迟 丢失唤醒时会等到单次唤醒, 远超此值 */
+
+static int tfd = -1;									 // 节拍定时器
+static int efd = -1;									 // 模拟中断唤醒CPU
+static stimer_timeout_process stimer_cb = NULL;			 // 节拍回调
+static uint32_t tick_us = 0;							 // 节拍周期 微秒
+static uint32_t sleep_ticks = 0;						 // 本次单次唤醒设定的节拍数 0表示周期节拍模式
+static uint64_t sleep_start_ns = 0;						 // 本次休眠开始的时间
+static uint64_t sleep_remain_ns = 0;					 // 提前唤醒时不足一个节拍的时间, 累加到下一次休眠
+static uint32_t wakeups = 0;							 // 本秒内的唤醒次数
+static stimer_handle irq_task = NULL;					 // 由模拟中断通知的事件任务
+static volatile uint64_t irq_post_ns = 0;				 // 最近一次投递的时间
+static uint64_t irq_latency_max_ns = 0;					 // 投递到执行的最长延迟
+static uint32_t irq_runs = 0;							 // 事件任务的执行次数
+static uint32_t report_rounds = 0;						 // 已统计的秒数
+static bool failed = false;								 // 结果不符合预期
+
+static uint64_t host_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void arm(uint64_t us, int periodic)
+{
+	struct itimerspec its = { 0 };
+	its.it_value.tv_sec = us / 1000000;
+	its.it_value.tv_nsec = (us % 1000000) * 1000L;
+	if (periodic)
+		its.it_interval = its.it_value;
+	timerfd_settime(tfd, 0, &its, NULL);
+}
+
+/************************************PORT************************************/
+
+static void host_init(uint32_t period_us, stimer_timeout_process f_timeout)
+{
+	tfd = timerfd_create(CLOCK_MONOTONIC, 0);
+	efd = eventfd(0, EFD_NONBLOCK);
+	tick_us = period_us;
+	stimer_cb = f_timeout;
+}
+
+static void host_start(void)
+{
+	arm(tick_us, 1);
+}
+
+static void host_wakeup(uint32_t ticks)
+{
+	sleep_ticks = ticks;
+	sleep_start_ns = host_now_ns();
+	arm((uint64_t)ticks * tick_us, 0);
+}
+
+static uint32_t host_idle(void)
+{
+	struct pollfd fds[2] = { { .fd = tfd, .events = POLLIN }, { .fd = efd, .events = POLLIN } };
+	uint64_t cnt = 0;
+	uint32_t elapsed = 0;
+
+	// 相当于关中断后再确认一次: eventfd 的计数在读走之前一直有效, 确认之后的投递同样会让 poll 立即返回
+	if (!stimer_work_pending())
+		poll(fds, 2, -1);
+	++wakeups;
+
+	if (read(efd, &cnt, sizeof(cnt)) < 0)
+		cnt = 0;
+
+	if (sleep_ticks) {
+		uint64_t tick_ns = tick_us * 1000ULL;
+		uint64_t passed = host_now_ns() - sleep_start_ns + sleep_remain_ns;
+
+		// 超出单次定时的部分由恢复后的周期节拍补上, 这里最多上报设定的节拍数
+		elapsed = passed / tick_ns;
+		if (elapsed >= sleep_ticks) {
+			elapsed = sleep_ticks;
+			sleep_remain_ns = 0;
+		} else {
+			sleep_remain_ns = passed % tick_ns;
+		}
+		sleep_ticks = 0;
+		arm(tick_us, 1); // 恢复周期节拍
+	} else if (fds[0].revents & POLLIN) {
+		if (read(tfd, &cnt, sizeof(cnt)) > 0) {
+			while (cnt--)
+				stimer_cb(); // 周期节拍模式下相当于节拍中断
+		}
+	}
+
+	return elapsed;
+}
+
+static struct timer_port host_port = {
+	.f_init_us = host_init,
+	.f_start = host_start,
+	.f_wakeup = host_wakeup, // 注释掉此行即可对比周期节拍模式下的唤醒次数
+	.f_idle = host_idle,
+};
+
+/************************************TASK************************************/
+
+// 模拟中断: 通知事件任务并唤醒CPU
+static void *irq_thread(void *arg)
+{
+	(void)arg;
+	uint64_t one = 1;
+
+	while (1) {
+		usleep(IRQ_PERIOD_US);
+		__atomic_store_n(&irq_post_ns, host_now_ns(), __ATOMIC_RELEASE);
+		stimer_task_notify(irq_task);
+		if (write(efd, &one, sizeof(one)) < 0)
+			break;
+	}
+
+	return NULL;
+}
+
+static void irq_task_f(void)
+{
+	uint64_t latency = host_now_ns() - __atomic_load_n(&irq_post_ns, __ATOMIC_ACQUIRE);
+
+	if (latency > irq_latency_max_ns)
+		irq_latency_max_ns = latency;
+	++irq_runs;
+}
+
+static void report_task(void)
+{
+	// 第一秒包含启动过程, 不计入
+	if (report_rounds++) {
+		printf("wakeups per second: %u\n", wakeups);
+		if (wakeups > WAKEUP_LIMIT)
+			failed = true;
+	}
+	wakeups = 0;
+
+	if (report_rounds <= REPORT_ROUNDS)
+		return;
+
+	printf("irq runs: %u, max latency: %.1f us\n", irq_runs, irq_latency_max_ns / 1000.0);
+	if (!irq_runs || irq_latency_max_ns > IRQ_LATENCY_MAX_US * 1000ULL)
+		failed = true;
+
+	printf("%s\n", failed ? "FAIL" : "PASS");
+	exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static void slow_task(void)
+{
+}
+
+int main(void)
+{
+	pthread_t th;
+
+	if (!stimer_init(&host_port))
+		return EXIT_FAILURE;
+
+	irq_task = stimer_task_create_ex(&(struct stimer_task_attr){ .task_f = irq_task_f });
+	if (!irq_task || !stimer_task_create(NULL, report_task, 1000) || !stimer_task_create(NULL, slow_task, 500))
+		return EXIT_FAILURE;
+
+	if (pthread_create(&th, NULL, irq_thread, NULL))
+		return EXIT_FAILURE;
+
+	stimer_start();
+
+	return EXIT_SUCCESS;
+}
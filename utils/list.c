@@ -99,3 +99,24 @@ uint8_t list_add_tail(list_item *head, list_item *item)
 	list_insert(item, head->pre, head);
 	return 0;
 }
+
+void list_splice_tail_init(list_item *head, list_item *list)
+{
+	if (!is_head_valid(head) || is_head_empty(list))
+		return;
+
+	list_item *first = list->next;
+	list_item *last = list->pre;
+
+	first->pre = head->pre;
+	head->pre->next = first;
+	last->next = head;
+	head->pre = last;
+
+	list_init(list);
+}
+
+uint8_t list_is_empty(list_item *head)
+{
+	return is_head_empty(head);
+}
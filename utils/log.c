@@ -39,6 +39,7 @@
 
 #include "utils/log.h"
 #include "utils/queue.h"
+#include "utils/stimer.h"
 
 #if USE_TIME_STAMP
 #include <time.h>
@@ -56,9 +57,8 @@ static uint8_t log_buffer[LOG_BUFFER_SIZE]; /* 日志缓冲区 */
 struct syslog_instance {
 	struct log_interface *interface;  // 串口接口
 	struct queue_info log_queue;	  // 日志队列
-	uint32_t timestamp;				  // 时间戳
-	uint32_t pre_time;				  // 时间戳计数
-	uint32_t period_md;				  // 任务周期
+	uint32_t timestamp;				  // 设置的时间戳
+	uint64_t time_ref_us;			  // 设置时间戳时的调度器时间
 	bool initialized;				  // 是否初始化
 	enum log_level current_log_level; // 当前日志等级
 };
@@ -91,17 +91,25 @@ static size_t syslog_write(struct syslog_instance *instance, uint8_t *buf, size_
 	if (!check_instance(instance))
 		return 0;
 
-#if USE_TIME_STAMP
+#if USE_TIME_STAMP || USE_UPTIME_STAMP
 	char time_buffer[64] = "NO_TIME";
+	uint64_t now_us = stimer_now_us();
 
-	time_t raw_time = (time_t)instance->timestamp;
+#if USE_TIME_STAMP
+	uint64_t elapsed_us = now_us - instance->time_ref_us;
+	time_t raw_time = (time_t)(instance->timestamp + elapsed_us / 1000000);
 	struct tm time_info;
 
 	if (localtime_r(&raw_time, &time_info) != NULL) {
-		strftime(time_buffer, sizeof(time_buffer), "[%Y-%m-%d %H:%M:%S]", &time_info);
+		size_t n = strftime(time_buffer, sizeof(time_buffer), "[%Y-%m-%d %H:%M:%S", &time_info);
+		snprintf(time_buffer + n, sizeof(time_buffer) - n, ".%03u]", (unsigned)(elapsed_us / 1000 % 1000));
 	} else {
 		snprintf(time_buffer, sizeof(time_buffer), "[NO_TIME]");
 	}
+#else
+	snprintf(time_buffer, sizeof(time_buffer), "[%lu.%03u]", (unsigned long)(now_us / 1000000),
+		(unsigned)(now_us / 1000 % 1000));
+#endif
 
 	char new_buf[MAX_LOG_LENGTH];
 	size_t new_len = snprintf(new_buf, sizeof(new_buf), "%s %.*s", time_buffer, (int)len, buf);
@@ -142,15 +150,6 @@ static void syslog_show(struct syslog_instance *instance)
 	if (!check_instance(instance))
 		return;
 
-#if USE_TIME_STAMP
-	instance->pre_time += instance->period_md;
-
-	if (instance->pre_time >= 1000) {
-		instance->timestamp++;
-		instance->pre_time = 0;
-	}
-#endif
-
 	while (!is_queue_empty(&instance->log_queue) && instance->interface->check_over()) {
 		// 日志长度信息
 		size_t flush_len = 0;
@@ -184,8 +183,10 @@ void syslog_init(struct log_interface *interface, uint32_t period_ms)
 	if (!interface || !interface->read || !interface->write || !interface->check_over)
 		return;
 
+	(void)period_ms;
+
 	syslog.interface = interface;
-	syslog.period_md = period_ms;
+	syslog.time_ref_us = stimer_now_us();
 	syslog.current_log_level = LOG_LEVEL_INFO; // 默认日志等级为INFO
 
 	queue_init(&syslog.log_queue, sizeof(uint8_t), log_buffer, LOG_BUFFER_SIZE);
@@ -265,14 +266,16 @@ void syslog_set_level(enum log_level level)
 /* 设置系统时间戳 */
 void syslog_set_time(uint32_t timestamp)
 {
-	if (check_instance(&syslog))
+	if (check_instance(&syslog)) {
 		syslog.timestamp = timestamp;
+		syslog.time_ref_us = stimer_now_us();
+	}
 }
 
 /* 获取系统当前时间戳 */
 uint32_t syslog_get_time(void)
 {
 	if (check_instance(&syslog))
-		return syslog.timestamp;
+		return syslog.timestamp + (uint32_t)((stimer_now_us() - syslog.time_ref_us) / 1000000);
 	return 0;
 }
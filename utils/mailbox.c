@@ -0,0 +1,255 @@
+/**
+ * @file mailbox.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 核间邮箱
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+#include "utils/mailbox.h"
+
+/* 获取较小的值 */
+static inline uint32_t mb_min(uint32_t a, uint32_t b)
+{
+	return (a <= b) ? a : b;
+}
+
+/**
+ * @brief 发送端可用的空间 空间不足时才重新读取接收端的读索引
+ * 
+ * @param mb 邮箱
+ * @param wr 写索引
+ * @param need 需要的消息数
+ * @return uint32_t 可用的消息数
+ */
+static uint32_t mailbox_space(struct mailbox *mb, uint32_t wr, uint32_t need)
+{
+	uint32_t space = mb->mask + 1 - (wr - mb->rd_cache);
+
+	if (space < need) {
+		// 获取语义: 读到新的读索引后, 接收端对这些消息的读取已经完成, 可以覆盖
+		mb->rd_cache = __atomic_load_n(&mb->rd, __ATOMIC_ACQUIRE);
+		space = mb->mask + 1 - (wr - mb->rd_cache);
+	}
+
+	return space;
+}
+
+/**
+ * @brief 接收端可读的消息数 不足时才重新读取发送端的写索引
+ * 
+ * @param mb 邮箱
+ * @param rd 读索引
+ * @param need 需要的消息数
+ * @return uint32_t 可读的消息数
+ */
+static uint32_t mailbox_avail(struct mailbox *mb, uint32_t rd, uint32_t need)
+{
+	uint32_t avail = mb->wr_cache - rd;
+
+	if (avail < need) {
+		// 与 mailbox_publish 中的屏障配对: 之前归还空间时写入的读索引先于写索引的读取, 两端不会同时错过对方
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		// 获取语义: 读到新的写索引后, 发送端对这些消息的写入已经可见
+		mb->wr_cache = __atomic_load_n(&mb->wr, __ATOMIC_ACQUIRE);
+		avail = mb->wr_cache - rd;
+	}
+
+	return avail;
+}
+
+/**
+ * @brief 发布写索引 邮箱由空变为非空时响铃
+ * 
+ * @param mb 邮箱
+ * @param wr 发布前的写索引
+ * @param num 发布的消息数
+ */
+static void mailbox_publish(struct mailbox *mb, uint32_t wr, uint32_t num)
+{
+	// 释放语义: 消息内容先于写索引对接收端可见
+	__atomic_store_n(&mb->wr, wr + num, __ATOMIC_RELEASE);
+
+	if (!mb->doorbell)
+		return;
+
+	// 写索引的写入与读索引的读取之间不能重排, 否则接收端检查为空后进入等待时可能错过门铃
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	mb->rd_cache = __atomic_load_n(&mb->rd, __ATOMIC_RELAXED);
+	if (mb->rd_cache == wr)
+		mb->doorbell(mb->doorbell_arg);
+}
+
+/**
+ * @brief 在环形缓冲与线性缓冲之间复制 处理回绕
+ * 
+ * @param mb 邮箱
+ * @param idx 环形缓冲中的起始索引
+ * @param data 线性缓冲
+ * @param num 消息数
+ * @param to_ring 为true时写入环形缓冲
+ */
+static void mailbox_copy(struct mailbox *mb, uint32_t idx, uint8_t *data, uint32_t num, bool to_ring)
+{
+	uint32_t pos = idx & mb->mask;
+	uint32_t tail = mb_min(num, mb->mask + 1 - pos);
+	uint8_t *ring = mb->buf + pos * mb->unit_bytes;
+
+	if (to_ring) {
+		memcpy(ring, data, tail * mb->unit_bytes);
+		memcpy(mb->buf, data + tail * mb->unit_bytes, (num - tail) * mb->unit_bytes);
+	} else {
+		memcpy(data, ring, tail * mb->unit_bytes);
+		memcpy(data + tail * mb->unit_bytes, mb->buf, (num - tail) * mb->unit_bytes);
+	}
+}
+
+/************************************EXPOSE API************************************/
+
+bool mailbox_init(struct mailbox *mb, void *buf, size_t unit_bytes, size_t units)
+{
+	if (!mb || !buf || !unit_bytes || !units || (units & (units - 1)) || units > 0x80000000UL)
+		return false;
+
+	mb->buf = buf;
+	mb->unit_bytes = unit_bytes;
+	mb->mask = units - 1;
+	mb->doorbell = NULL;
+	mb->doorbell_arg = NULL;
+	mb->rd_cache = 0;
+	mb->wr_cache = 0;
+	mb->rd = 0;
+	__atomic_store_n(&mb->wr, 0, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+void mailbox_set_doorbell(struct mailbox *mb, mailbox_doorbell_f f, void *arg)
+{
+	if (!mb)
+		return;
+
+	mb->doorbell_arg = arg;
+	mb->doorbell = f;
+}
+
+size_t mailbox_post(struct mailbox *mb, const void *msg, size_t num)
+{
+	if (!mb || !msg || !num)
+		return 0;
+
+	if (num > mb->mask + 1)
+		num = mb->mask + 1;
+
+	uint32_t wr = mb->wr; // 只有发送端写入, 不需要原子读取
+	uint32_t n = mb_min(mailbox_space(mb, wr, num), num);
+	if (!n)
+		return 0;
+
+	mailbox_copy(mb, wr, (uint8_t *)msg, n, true);
+	mailbox_publish(mb, wr, n);
+
+	return n;
+}
+
+void *mailbox_reserve(struct mailbox *mb)
+{
+	if (!mb)
+		return NULL;
+
+	uint32_t wr = mb->wr;
+	if (!mailbox_space(mb, wr, 1))
+		return NULL;
+
+	return mb->buf + (wr & mb->mask) * mb->unit_bytes;
+}
+
+void mailbox_commit(struct mailbox *mb)
+{
+	if (!mb)
+		return;
+
+	uint32_t wr = mb->wr;
+	if (!mailbox_space(mb, wr, 1))
+		return;
+
+	mailbox_publish(mb, wr, 1);
+}
+
+size_t mailbox_fetch(struct mailbox *mb, void *msg, size_t num)
+{
+	if (!mb || !msg || !num)
+		return 0;
+
+	if (num > mb->mask + 1)
+		num = mb->mask + 1;
+
+	uint32_t rd = mb->rd; // 只有接收端写入, 不需要原子读取
+	uint32_t n = mb_min(mailbox_avail(mb, rd, num), num);
+	if (!n)
+		return 0;
+
+	mailbox_copy(mb, rd, (uint8_t *)msg, n, false);
+
+	// 释放语义: 消息读取完成后才归还空间
+	__atomic_store_n(&mb->rd, rd + n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+void *mailbox_peek(struct mailbox *mb)
+{
+	if (!mb)
+		return NULL;
+
+	uint32_t rd = mb->rd;
+	if (!mailbox_avail(mb, rd, 1))
+		return NULL;
+
+	return mb->buf + (rd & mb->mask) * mb->unit_bytes;
+}
+
+void mailbox_release(struct mailbox *mb)
+{
+	if (!mb)
+		return;
+
+	uint32_t rd = mb->rd;
+	if (!mailbox_avail(mb, rd, 1))
+		return;
+
+	__atomic_store_n(&mb->rd, rd + 1, __ATOMIC_RELEASE);
+}
+
+size_t mailbox_used(struct mailbox *mb)
+{
+	if (!mb)
+		return 0;
+
+	return __atomic_load_n(&mb->wr, __ATOMIC_ACQUIRE) - __atomic_load_n(&mb->rd, __ATOMIC_ACQUIRE);
+}
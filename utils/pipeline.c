@@ -0,0 +1,257 @@
+/**
+ * @file pipeline.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 基于调度组件的数据流水线
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "utils/stimer.h"
+#include "utils/pipeline.h"
+
+struct pipe_stage {
+	struct pipeline *pipe;
+	uint8_t idx; // 在流水线中的位置
+	const char *name;
+	pipe_stage_f f;
+	void *arg;
+	struct queue_info *in;
+	struct queue_info *out;
+	bool source;  // 周期执行的源
+	bool blocked; // 上次执行因输出队列已满而停止
+	stimer_handle task;
+	struct pipe_stage_stat stat;
+};
+
+struct pipeline {
+	const char *name;
+	struct pipe_stage *stages[PIPE_MAX_STAGE];
+	uint8_t num;
+	uint32_t missed; // 投递队列已满而未能唤醒的级 位图
+};
+
+/**
+ * @brief 唤醒流水线中的一级 失败时记录下来, 流水线中任意一级执行时重试
+ * 
+ * @param stage 级
+ */
+static void pipe_stage_notify(struct pipe_stage *stage)
+{
+	if (!stimer_task_notify(stage->task))
+		stage->pipe->missed |= 1UL << stage->idx;
+}
+
+/**
+ * @brief 重试之前未能唤醒的级
+ * 
+ * @param pipe 流水线
+ */
+static void pipe_retry_missed(struct pipeline *pipe)
+{
+	uint32_t missed = pipe->missed;
+
+	pipe->missed = 0;
+	for (uint8_t i = 0; missed; i++, missed >>= 1) {
+		if (missed & 1)
+			pipe_stage_notify(pipe->stages[i]);
+	}
+}
+
+/**
+ * @brief 一级是否可以继续处理
+ * 
+ * @param stage 级
+ * @return bool 
+ */
+static inline bool pipe_stage_ready(struct pipe_stage *stage)
+{
+	return (!stage->in || !is_queue_empty(stage->in)) && (!stage->out || !is_queue_full(stage->out));
+}
+
+/**
+ * @brief 所有级共用的任务函数
+ */
+static void pipe_stage_task(void)
+{
+	struct pipe_stage *stage = stimer_task_arg(stimer_self());
+	uint32_t consumed = 0, produced = 0;
+	uint8_t n;
+
+	if (!stage)
+		return;
+
+	if (stage->pipe->missed)
+		pipe_retry_missed(stage->pipe);
+
+	uint64_t begin_us = stimer_now_us();
+
+	for (n = 0; n < PIPE_STAGE_BATCH; n++) {
+		if (stage->in && is_queue_empty(stage->in))
+			break;
+
+		// 输出队列已满, 等待下一级取走数据后唤醒
+		if (stage->out && is_queue_full(stage->out)) {
+			stage->blocked = true;
+			++stage->stat.stalls;
+			break;
+		}
+
+		uint8_t ret = stage->f(queue_rd_unit(stage->in), queue_wr_unit(stage->out), stage->arg);
+
+		if ((ret & PIPE_CONSUMED) && stage->in) {
+			queue_advance_rd(stage->in, 1);
+			++consumed;
+		}
+		if ((ret & PIPE_PRODUCED) && stage->out) {
+			queue_advance_wr(stage->out, 1);
+			++produced;
+		}
+		// 周期执行的源每个周期只产生一个单元
+		if (!(ret & (PIPE_CONSUMED | PIPE_PRODUCED)) || stage->source)
+			break;
+	}
+
+	++stage->stat.runs;
+	stage->stat.in_units += consumed;
+	stage->stat.out_units += produced;
+	stage->stat.busy_us += (uint32_t)(stimer_now_us() - begin_us);
+
+	struct pipe_stage *prev = stage->idx ? stage->pipe->stages[stage->idx - 1] : NULL;
+	struct pipe_stage *next = stage->idx + 1 < stage->pipe->num ? stage->pipe->stages[stage->idx + 1] : NULL;
+
+	if (produced && next)
+		pipe_stage_notify(next);
+
+	// 腾出了空间, 唤醒因输出队列已满而停止的上一级 周期执行的源在下一周期自然恢复
+	if (consumed && prev && prev->blocked) {
+		prev->blocked = false;
+		if (!prev->source)
+			pipe_stage_notify(prev);
+	}
+
+	// 本次处理数达到上限, 重新排队让其他任务先执行
+	if (n == PIPE_STAGE_BATCH && !stage->source && pipe_stage_ready(stage))
+		pipe_stage_notify(stage);
+}
+
+/************************************EXPOSE API************************************/
+
+pipe_handle pipeline_create(const char *name)
+{
+	struct pipeline *pipe = calloc(1, sizeof(struct pipeline));
+	if (!pipe)
+		return NULL;
+
+	pipe->name = name;
+
+	return pipe;
+}
+
+pipe_stage_handle pipeline_add_stage(pipe_handle pipe, const struct pipe_stage_attr *attr)
+{
+	if (!pipe || !attr || !attr->f || pipe->num >= PIPE_MAX_STAGE)
+		return NULL;
+
+	struct pipe_stage *stage = calloc(1, sizeof(struct pipe_stage));
+	if (!stage)
+		return NULL;
+
+	stage->pipe = pipe;
+	stage->idx = pipe->num;
+	stage->name = attr->name;
+	stage->f = attr->f;
+	stage->arg = attr->arg;
+	stage->out = attr->out;
+	if (pipe->num) {
+		stage->in = pipe->stages[pipe->num - 1]->out;
+		if (!stage->in)
+			goto err; // 上一级已是最后一级
+	} else {
+		stage->in = attr->in;
+		stage->source = !attr->in && attr->period_ms;
+	}
+
+	struct stimer_task_attr task_attr = {
+		.name = attr->name,
+		.task_f = pipe_stage_task,
+		.period_ms = stage->source ? attr->period_ms : 0,
+		.arg = stage,
+	};
+
+	// 先加入流水线, 任务创建后即可能被唤醒
+	pipe->stages[pipe->num++] = stage;
+	stage->task = stimer_task_create_ex(&task_attr);
+	if (!stage->task) {
+		--pipe->num;
+		goto err;
+	}
+
+	return stage;
+
+err:
+	free(stage);
+	return NULL;
+}
+
+bool pipeline_wake(pipe_stage_handle stage)
+{
+	return stage ? stimer_task_notify(stage->task) : false;
+}
+
+bool pipeline_get_stat(pipe_stage_handle stage, struct pipe_stage_stat *stat)
+{
+	if (!stage || !stat)
+		return false;
+
+	*stat = stage->stat;
+	return true;
+}
+
+void pipeline_reset_stat(pipe_handle pipe)
+{
+	if (!pipe)
+		return;
+
+	for (uint8_t i = 0; i < pipe->num; i++)
+		memset(&pipe->stages[i]->stat, 0, sizeof(struct pipe_stage_stat));
+}
+
+pipe_stage_handle pipeline_stage_next(pipe_handle pipe, pipe_stage_handle prev)
+{
+	if (!pipe)
+		return NULL;
+
+	uint8_t idx = prev ? prev->idx + 1 : 0;
+	return idx < pipe->num ? pipe->stages[idx] : NULL;
+}
+
+const char *pipeline_stage_name(pipe_stage_handle stage)
+{
+	return (stage && stage->name) ? stage->name : "";
+}
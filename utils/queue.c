@@ -196,3 +196,45 @@ void queue_advance_wr(struct queue_info *q, size_t units)
 	size_t count = q_min(units, queue_remain_space(q));
 	q->wr += count;
 }
+
+/* 可连续读取的区域，以单元为单位 */
+void *queue_read_span(struct queue_info *q, size_t *units)
+{
+	if (!q || !units)
+		return NULL;
+
+	size_t index = q->rd % q->buf_size; // 实际读索引
+	*units = q_min(queue_used(q), q->buf_size - index);
+
+	return *units ? q->buf + (index * q->unit_bytes) : NULL;
+}
+
+/* 可连续写入的区域，以单元为单位 */
+void *queue_write_span(struct queue_info *q, size_t *units)
+{
+	if (!q || !units)
+		return NULL;
+
+	size_t index = q->wr % q->buf_size; // 实际写索引
+	*units = q_min(queue_remain_space(q), q->buf_size - index);
+
+	return *units ? q->buf + (index * q->unit_bytes) : NULL;
+}
+
+/* 最早的一个单元 */
+void *queue_rd_unit(struct queue_info *q)
+{
+	if (!q || is_queue_empty(q))
+		return NULL;
+
+	return q->buf + ((q->rd % q->buf_size) * q->unit_bytes);
+}
+
+/* 下一个可写入的单元 */
+void *queue_wr_unit(struct queue_info *q)
+{
+	if (!q || is_queue_full(q))
+		return NULL;
+
+	return q->buf + ((q->wr % q->buf_size) * q->unit_bytes);
+}
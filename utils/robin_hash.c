@@ -0,0 +1,367 @@
+/**
+ * @file robin_hash.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 开放寻址的字符串哈希表
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "utils/robin_hash.h"
+
+#define ROBIN_MIN_CAP (8) // 最小容量
+
+// FNV-1a hash
+static uint32_t robin_hash_key(const char *key)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*key) {
+		hash ^= (uint8_t)*key++;
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief 查找键所在的槽位
+ * 
+ * @param table 表实例
+ * @param key 键
+ * @param hash 键的哈希值
+ * @return struct robin_slot* 不存在时返回NULL
+ */
+static struct robin_slot *robin_lookup(struct robin_hash *table, const char *key, uint32_t hash)
+{
+	size_t mask = table->cap - 1;
+	size_t idx = hash & mask;
+
+	for (uint32_t dist = 1;; dist++, idx = (idx + 1) & mask) {
+		struct robin_slot *slot = &table->slots[idx];
+
+		// 空槽位, 或者该槽位元素的探测距离比当前短, 如果键存在早已替换了它
+		if (slot->dist < dist)
+			return NULL;
+
+		if (slot->hash == hash && strcmp(slot->key, key) == 0)
+			return slot;
+	}
+}
+
+/**
+ * @brief 放入一个确定不存在的元素 探测距离较短的元素让位
+ * 
+ * @param slots 槽位数组
+ * @param cap 容量
+ * @param item 元素
+ */
+static void robin_place(struct robin_slot *slots, size_t cap, struct robin_slot item)
+{
+	size_t mask = cap - 1;
+	size_t idx = item.hash & mask;
+
+	for (item.dist = 1;; item.dist++, idx = (idx + 1) & mask) {
+		struct robin_slot *slot = &slots[idx];
+
+		if (!slot->dist) {
+			*slot = item;
+			return;
+		}
+
+		if (slot->dist < item.dist) {
+			struct robin_slot tmp = *slot;
+			*slot = item;
+			item = tmp;
+		}
+	}
+}
+
+/**
+ * @brief 调整容量 使用保存的哈希值重新放置所有元素
+ * 
+ * @param table 表实例
+ * @param cap 新容量 2的幂
+ * @return enum hash_error 错误码
+ */
+static enum hash_error robin_resize(struct robin_hash *table, size_t cap)
+{
+	struct robin_slot *slots = (struct robin_slot *)calloc(cap, sizeof(struct robin_slot));
+	if (!slots)
+		return HASH_POINT_ERROR;
+
+	for (size_t i = 0; i < table->cap; i++) {
+		if (table->slots[i].dist)
+			robin_place(slots, cap, table->slots[i]);
+	}
+
+	free(table->slots);
+	table->slots = slots;
+	table->cap = cap;
+
+	return HASH_SUCCESS;
+}
+
+/**
+ * @brief 复制键到字符串区
+ * 
+ * @param table 表实例
+ * @param key 键
+ * @return const char* 复制后的键 失败返回NULL
+ */
+static const char *robin_intern(struct robin_hash *table, const char *key)
+{
+	size_t len = strlen(key) + 1;
+	struct robin_arena *arena = table->arena;
+
+	if (!arena || arena->size - arena->used < len) {
+		size_t size = len > ROBIN_HASH_ARENA_SIZE ? len : ROBIN_HASH_ARENA_SIZE;
+		arena = (struct robin_arena *)malloc(sizeof(struct robin_arena) + size);
+		if (!arena)
+			return NULL;
+
+		arena->size = size;
+		arena->used = 0;
+
+		// 长键单独成块时放在当前块之后, 当前块剩余的空间仍可继续使用
+		if (table->arena && size > ROBIN_HASH_ARENA_SIZE) {
+			arena->next = table->arena->next;
+			table->arena->next = arena;
+		} else {
+			arena->next = table->arena;
+			table->arena = arena;
+		}
+	}
+
+	char *copy = arena->data + arena->used;
+	memcpy(copy, key, len);
+	arena->used += len;
+
+	return copy;
+}
+
+/**
+ * @brief 释放全部字符串区
+ * 
+ * @param table 表实例
+ */
+static void robin_arena_free(struct robin_hash *table)
+{
+	while (table->arena) {
+		struct robin_arena *next = table->arena->next;
+		free(table->arena);
+		table->arena = next;
+	}
+
+	table->key_bytes = 0;
+	table->garbage = 0;
+}
+
+/**
+ * @brief 回收已删除的键占用的空间 把存活的键复制到一个新块中
+ * 
+ * 已删除的键累计超过一块且超过存活的键时才回收, 复制的字节数不超过此前删除的字节数
+ * 
+ * @param table 表实例
+ */
+static void robin_arena_compact(struct robin_hash *table)
+{
+	if (!table->count) {
+		robin_arena_free(table);
+		return;
+	}
+
+	if (table->garbage < ROBIN_HASH_ARENA_SIZE || table->garbage < table->key_bytes)
+		return;
+
+	size_t size = table->key_bytes > ROBIN_HASH_ARENA_SIZE ? table->key_bytes : ROBIN_HASH_ARENA_SIZE;
+	struct robin_arena *arena = (struct robin_arena *)malloc(sizeof(struct robin_arena) + size);
+	if (!arena)
+		return; // 内存不足时保留原来的块, 下次删除时再尝试
+
+	arena->next = NULL;
+	arena->size = size;
+	arena->used = 0;
+
+	for (size_t i = 0; i < table->cap; i++) {
+		struct robin_slot *slot = &table->slots[i];
+		if (!slot->dist)
+			continue;
+
+		size_t len = strlen(slot->key) + 1;
+		memcpy(arena->data + arena->used, slot->key, len);
+		slot->key = arena->data + arena->used;
+		arena->used += len;
+	}
+
+	size_t key_bytes = table->key_bytes;
+	robin_arena_free(table);
+	table->arena = arena;
+	table->key_bytes = key_bytes;
+}
+
+enum hash_error robin_hash_init(struct robin_hash *table, size_t capacity)
+{
+	if (!table)
+		return HASH_POINT_ERROR;
+
+	// 按 7/8 的装载上限换算为2的幂
+	size_t cap = ROBIN_MIN_CAP;
+	while (cap - cap / 8 < capacity)
+		cap <<= 1;
+
+	table->slots = (struct robin_slot *)calloc(cap, sizeof(struct robin_slot));
+	if (!table->slots)
+		return HASH_POINT_ERROR;
+
+	table->cap = cap;
+	table->count = 0;
+	table->arena = NULL;
+	table->key_bytes = 0;
+	table->garbage = 0;
+
+	return HASH_SUCCESS;
+}
+
+enum hash_error robin_hash_insert(struct robin_hash *table, const char *key, void *private)
+{
+	if (!table || !table->slots || !key)
+		return HASH_POINT_ERROR;
+
+	uint32_t hash = robin_hash_key(key);
+
+	struct robin_slot *slot = robin_lookup(table, key, hash);
+	if (slot) {
+		slot->private = private;
+		return HASH_SUCCESS;
+	}
+
+	if (table->count + 1 > table->cap - table->cap / 8) {
+		if (robin_resize(table, table->cap << 1) != HASH_SUCCESS)
+			return HASH_POINT_ERROR;
+	}
+
+	struct robin_slot item = { .hash = hash, .private = private };
+	item.key = robin_intern(table, key);
+	if (!item.key)
+		return HASH_POINT_ERROR;
+
+	robin_place(table->slots, table->cap, item);
+	table->count++;
+	table->key_bytes += strlen(item.key) + 1;
+
+	return HASH_SUCCESS;
+}
+
+void *robin_hash_find(struct robin_hash *table, const char *key, enum hash_error *error)
+{
+	if (!table || !table->slots || !key) {
+		if (error)
+			*error = HASH_POINT_ERROR;
+
+		return NULL;
+	}
+
+	struct robin_slot *slot = robin_lookup(table, key, robin_hash_key(key));
+
+	if (error)
+		*error = slot ? HASH_SUCCESS : HASH_KEY_NOT_FOUND;
+
+	return slot ? slot->private : NULL;
+}
+
+enum hash_error robin_hash_delete(struct robin_hash *table, const char *key)
+{
+	if (!table || !table->slots || !key)
+		return HASH_POINT_ERROR;
+
+	struct robin_slot *slot = robin_lookup(table, key, robin_hash_key(key));
+	if (!slot)
+		return HASH_KEY_NOT_FOUND;
+
+	size_t len = strlen(slot->key) + 1;
+	table->key_bytes -= len;
+	table->garbage += len;
+
+	// 后续元素依次前移一格, 直到空槽位或已在理想位置的元素, 不需要墓碑标记
+	size_t mask = table->cap - 1;
+	size_t idx = slot - table->slots;
+	size_t next = (idx + 1) & mask;
+
+	while (table->slots[next].dist > 1) {
+		table->slots[idx] = table->slots[next];
+		table->slots[idx].dist--;
+		idx = next;
+		next = (next + 1) & mask;
+	}
+
+	memset(&table->slots[idx], 0, sizeof(struct robin_slot));
+	table->count--;
+
+	robin_arena_compact(table);
+
+	return HASH_SUCCESS;
+}
+
+size_t robin_hash_count(struct robin_hash *table)
+{
+	return table ? table->count : 0;
+}
+
+bool robin_hash_next(struct robin_hash *table, size_t *iter, const char **key, void **private)
+{
+	if (!table || !table->slots || !iter)
+		return false;
+
+	while (*iter < table->cap) {
+		struct robin_slot *slot = &table->slots[(*iter)++];
+		if (!slot->dist)
+			continue;
+
+		if (key)
+			*key = slot->key;
+		if (private)
+			*private = slot->private;
+		return true;
+	}
+
+	return false;
+}
+
+void robin_hash_destroy(struct robin_hash *table)
+{
+	if (!table)
+		return;
+
+	robin_arena_free(table);
+
+	free(table->slots);
+	table->slots = NULL;
+	table->cap = 0;
+	table->count = 0;
+}
@@ -34,213 +34,1820 @@
 #include "utils/list.h"
 #include "utils/stimer.h"
 
-#define HIT_LIST_MASK (STIMER_TASK_HIT_LIST_MAX - 1)
-#define HIT_LIST_IDX(t) ((m_timer.pre_tick + (t)) & HIT_LIST_MASK)
+/**
+ * 分层时间轮
+ * 
+ * 共 STIMER_WHEEL_LEVELS 级, 每级 STIMER_WHEEL_SIZE 个槽位, 第 n 级每个槽位跨度为 STIMER_WHEEL_SIZE^n 个节拍
+ * 任务按到期节拍与当前节拍的差值放入对应级别的槽位, 插入为 O(1)
+ * 当低级时间轮转过一圈时, 将高一级当前槽位中的任务重新分配(级联)到低级时间轮, 每个任务最多被级联 STIMER_WHEEL_LEVELS - 1 次
+ * 
+ * 第2级及以上的槽位容纳的任务多, 一次级联完会在该节拍产生明显的抖动, 因此提前一个低一级槽位的跨度
+ * (第 n 级为 STIMER_WHEEL_SIZE^(n-1) 个节拍)把该槽位摘下, 之后每个节拍最多级联 STIMER_WHEEL_CASCADE_BUDGET 个任务,
+ * 到达该槽位的起始节拍时再一次处理剩余的任务
+ * 因此每个节拍的调度开销只与当前到期的任务数有关, 与总任务数无关; 最坏情况下(第 n 级一个槽位的任务数
+ * 超过 STIMER_WHEEL_CASCADE_BUDGET * STIMER_WHEEL_SIZE^(n-1)) 超出的部分仍在槽位的起始节拍一次级联
+ */
+#define STIMER_WHEEL_BITS (5)			   /* 每级时间轮槽位数的位宽 */
+#define STIMER_WHEEL_LEVELS (4)			   /* 时间轮级数 可覆盖 2^(5*4) 个节拍 */
+#define STIMER_WHEEL_CASCADE_BUDGET (32) /* 提前级联时每个节拍每级最多处理的任务数 */
+
+#if STIMER_WHEEL_BITS > 5
+#error "STIMER_WHEEL_BITS must not exceed 5, each level uses a 32-bit slot bitmap"
+#endif
+
+#define STIMER_WHEEL_SIZE (1UL << STIMER_WHEEL_BITS)
+#define STIMER_WHEEL_MASK (STIMER_WHEEL_SIZE - 1)
+#define STIMER_WHEEL_RANGE (1UL << (STIMER_WHEEL_BITS * STIMER_WHEEL_LEVELS))
+#define WHEEL_IDX(t, lv) (((t) >> ((lv) * STIMER_WHEEL_BITS)) & STIMER_WHEEL_MASK)
+
+#if (STIMER_WORK_QUEUE_SIZE & (STIMER_WORK_QUEUE_SIZE - 1)) != 0
+#error "STIMER_WORK_QUEUE_SIZE must be a power of 2"
+#endif
+
+#define STIMER_WORK_MASK (STIMER_WORK_QUEUE_SIZE - 1)
+
+#if STIMER_ENABLE_GOVERNOR && !STIMER_ENABLE_PROFILE
+#error "STIMER_ENABLE_GOVERNOR requires STIMER_ENABLE_PROFILE"
+#endif
+
+#if (STIMER_TICK_US >= 1000) ? (STIMER_TICK_US % 1000) : (1000 % STIMER_TICK_US)
+#error "STIMER_TICK_US must be a divisor or a multiple of 1000"
+#endif
+
+#if STIMER_TICK_US >= 1000
+#define Period_to_Tick(p) (((p) >= STIMER_PERIOD_PER_TICK_MS) ? ((p) / STIMER_PERIOD_PER_TICK_MS) : 1U)
+#else
+#define Period_to_Tick(p) ((p) ? (p) * (1000 / STIMER_TICK_US) : 1U)
+#endif
+#define Us_to_Tick(u) (((u) >= STIMER_TICK_US) ? ((u) / STIMER_TICK_US) : 1U)
+
+#define STIMER_EPOCH_SPAN (0x40000000UL) // 节拍计数距离基准超过该值时更新基准
+
+/**
+ * 中断投递队列
+ * 
+ * 多生产者(各级中断)单消费者(主循环)的无锁环形队列:
+ * 生产者通过 CAS 预留写位置, 写入内容后再以 release 语义写入序号, 标记该位置已写完
+ * 消费者按读位置检查序号, 序号与读位置匹配才读取, 因此不会读到写了一半的内容
+ * f 为NULL时 arg 为被通知的任务
+ */
+struct stimer_work {
+	stimer_work_f f;
+	void *arg;
+	uint32_t seq; // 写完后置为写位置+1
+};
+
+/**
+ * 64位节拍计数的基准
+ * 
+ * 32位节拍计数约49天(1毫秒节拍)回绕一次, 主循环在计数距离基准较远时更新基准, 64位计数 = 基准 + (当前计数 - 基准低32位)
+ * 基准使用双缓冲: 主循环写入未使用的一份后再切换下标, 中断中读取时不会读到更新了一半的基准
+ */
+struct stimer_epoch {
+	uint32_t lo;
+	uint32_t hi;
+};
+
+struct stimer_ctx {
+	volatile uint32_t pre_tick;	 // 时间轮已处理到的节拍
+	volatile uint32_t cur_tick;	 // 定时器中断累加的节拍
+	volatile uint32_t idle_tick; // 无节拍休眠期间补偿的节拍 只在主循环中修改
+	volatile int run_flag;
+	stimer_base_start f_start;
+	stimer_base_wakeup f_wakeup;
+	stimer_base_idle f_idle;
+	stimer_base_cycle f_get_subtick;
+	struct stimer_epoch epoch[2]; // 64位节拍计数的基准
+	volatile uint8_t epoch_idx;	  // 正在使用的基准
+	list_item wheel[STIMER_WHEEL_LEVELS][STIMER_WHEEL_SIZE];
+	uint32_t wheel_bitmap[STIMER_WHEEL_LEVELS];	// 非空槽位位图 置位的槽位可能已为空, 查找时再确认
+	list_item wheel_pend[STIMER_WHEEL_LEVELS];		// 提前摘下 正在分批级联的槽位 只用于第2级及以上
+	uint32_t wheel_pend_end[STIMER_WHEEL_LEVELS];	// 分批级联必须完成的节拍 即该槽位的起始节拍
+	struct stimer_task *current;				// 当前正在执行的周期任务
+	stimer_trace_f f_trace;						// 任务释放与执行的跟踪 用于仿真
+	void *trace_arg;
+
+	list_item timer_free; // 软件定时器空闲链表
+	list_item task_list;  // 所有周期任务
+
+	struct stimer_task timer_pool[STIMER_MAX_TIMER]; // 软件定时器池
+
+#if STIMER_MAX_FAST_TASK > 0
+	struct stimer_task *fast[STIMER_MAX_FAST_TASK]; // 快速任务 只增不减, 节拍中断中遍历
+	volatile uint8_t fast_num;
+#endif
+
+	struct stimer_work work[STIMER_WORK_QUEUE_SIZE];
+	uint32_t work_wr; // 生产者预留的写位置
+	uint32_t work_rd; // 消费者的读位置
+#if STIMER_ENABLE_BUDGET
+	stimer_budget_hook budget_hook; // 执行时间超出预算时的处理
+#endif
+#if STIMER_ENABLE_PROFILE || STIMER_ENABLE_BUDGET
+	stimer_base_cycle f_get_cycle;
+	uint32_t cycle_per_us;
+#endif
+#if STIMER_ENABLE_PROFILE
+	volatile uint32_t stamp_tick;  // 最近一次节拍中断的节拍
+	volatile uint32_t stamp_cycle; // 最近一次节拍中断时的计数值
+	uint32_t mark_cycle;		   // 调度循环上一次切换忙/闲状态时的计数值
+	uint64_t busy_cycle;
+	uint64_t idle_cycle;
+	uint64_t fast_cycle; // 节拍中断中执行快速任务的计数值
+#endif
+#if STIMER_ENABLE_GOVERNOR
+	uint64_t gov_busy;	// 当前统计窗口内的忙计数
+	uint64_t gov_idle;	// 当前统计窗口内的闲计数
+	uint32_t gov_tick;	// 当前统计窗口的起始节拍
+	uint8_t shed_level;	// 当前降级等级
+#endif
+};
+
+static struct stimer_ctx m_timer = { 0 }; // 默认实例
+
+static inline int is_timer_run(struct stimer_ctx *ctx)
+{
+	return ctx->run_flag == 1;
+}
+
+#if STIMER_ENABLE_PROFILE
+
+#define PROF_CYCLE_PER_TICK(ctx) ((ctx)->cycle_per_us * STIMER_TICK_US)
+#define PROF_CYCLE_TO_US(ctx, c) ((ctx)->cycle_per_us ? (uint32_t)((c) / (ctx)->cycle_per_us) : 0)
+
+static inline uint32_t prof_get_cycle(struct stimer_ctx *ctx)
+{
+	return ctx->f_get_cycle ? ctx->f_get_cycle() : 0;
+}
+
+/**
+ * @brief 推算释放节拍对应的计数值
+ * 
+ * 以最近一次节拍中断的时刻为基准, 按节拍差折算
+ * 
+ * @param release 释放节拍
+ * @return uint32_t 计数值
+ */
+static uint32_t prof_release_cycle(struct stimer_ctx *ctx, uint32_t release)
+{
+	uint32_t tick, cycle;
+
+	// 节拍中断可能在读取过程中更新基准
+	do {
+		tick = ctx->stamp_tick;
+		cycle = ctx->stamp_cycle;
+	} while (tick != ctx->stamp_tick);
+
+	return cycle + (int32_t)(release - ctx->idle_tick - tick) * (int32_t)PROF_CYCLE_PER_TICK(ctx);
+}
+
+/**
+ * @brief 调度循环切换忙/闲状态, 累计上一段状态的时间
+ * 
+ * @param busy 上一段是否处于忙状态
+ */
+static void prof_mark(struct stimer_ctx *ctx, bool busy)
+{
+	uint32_t now = prof_get_cycle(ctx);
+
+	if (busy)
+		ctx->busy_cycle += now - ctx->mark_cycle;
+	else
+		ctx->idle_cycle += now - ctx->mark_cycle;
+
+#if STIMER_ENABLE_GOVERNOR
+	if (busy)
+		ctx->gov_busy += now - ctx->mark_cycle;
+	else
+		ctx->gov_idle += now - ctx->mark_cycle;
+#endif
+
+	ctx->mark_cycle = now;
+}
+
+static void prof_record(struct stimer_task *task, uint32_t latency, uint32_t exec)
+{
+	struct stimer_prof_data *prof = &task->prof;
+
+	if ((int32_t)latency < 0)
+		latency = 0;
+
+	if (prof->count == 0 || exec < prof->exec_min)
+		prof->exec_min = exec;
+	if (exec > prof->exec_max)
+		prof->exec_max = exec;
+	if (latency > prof->latency_max)
+		prof->latency_max = latency;
+
+	prof->exec_sum += exec;
+	prof->latency_sum += latency;
+	++prof->count;
+}
+
+#endif /* STIMER_ENABLE_PROFILE */
+
+#if STIMER_MAX_FAST_TASK > 0
+/**
+ * @brief 执行到期的快速任务 在节拍中断中调用
+ * 
+ * 节拍中断每个节拍都会执行, 到期即执行, 下次到期从本节拍起按周期计算
+ * 
+ * @param ctx 调度器实例
+ */
+static void stimer_fast_dispatch(struct stimer_ctx *ctx)
+{
+	uint8_t num = __atomic_load_n(&ctx->fast_num, __ATOMIC_ACQUIRE);
+	uint32_t now = ctx->cur_tick;
+
+#if STIMER_ENABLE_PROFILE
+	uint32_t begin = prof_get_cycle(ctx);
+	uint32_t end = begin;
+#endif
+
+	for (uint8_t i = 0; i < num; i++) {
+		struct stimer_task *task = ctx->fast[i];
+
+		// 主循环修改的周期由这里应用, 周期与到期节拍只在节拍中断中写入
+		if (__atomic_load_n(&task->period_req, __ATOMIC_RELAXED))
+			task->period = __atomic_exchange_n(&task->period_req, 0, __ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&task->suspended, __ATOMIC_ACQUIRE) || (int32_t)(now - task->expires) < 0)
+			continue;
+
+		task->expires = now + task->period;
+		++task->stat.runs;
+
+		if (ctx->f_trace) {
+			ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_RELEASE, now);
+			ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_START, now);
+		}
+
+#if STIMER_ENABLE_PROFILE
+		uint32_t start = end;
+
+		task->task_f();
+		end = prof_get_cycle(ctx);
+
+		if (ctx->f_get_cycle) {
+			prof_record(task, start - ctx->stamp_cycle, end - start);
+			if (PROF_CYCLE_TO_US(ctx, end - start) > STIMER_FAST_MAX_US)
+				++task->stat.budget_overrun;
+		}
+#else
+		task->task_f();
+#endif
+
+		if (ctx->f_trace)
+			ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_END, ctx->cur_tick);
+	}
+
+#if STIMER_ENABLE_PROFILE
+	ctx->fast_cycle += end - begin;
+#endif
+}
+#endif /* STIMER_MAX_FAST_TASK > 0 */
+
+static inline void _timer_update(void)
+{
+	struct stimer_ctx *ctx = &m_timer;
+
+	++ctx->cur_tick;
+
+#if STIMER_ENABLE_PROFILE
+	if (ctx->f_get_cycle) {
+		ctx->stamp_cycle = ctx->f_get_cycle();
+		ctx->stamp_tick = ctx->cur_tick;
+	}
+#endif
+
+#if STIMER_MAX_FAST_TASK > 0
+	if (is_timer_run(ctx))
+		stimer_fast_dispatch(ctx);
+#endif
+}
+
+/**
+ * @brief 从空闲链表中分配软件定时器
+ * 
+ * @param ctx 调度器实例
+ * @param kind 节点类型
+ * @return struct stimer_task* 定时器已用完返回NULL
+ */
+static struct stimer_task *timer_allocate(struct stimer_ctx *ctx, uint8_t kind)
+{
+	if (list_is_empty(&ctx->timer_free))
+		return NULL;
+
+	struct stimer_task *timer = container_of(ctx->timer_free.next, struct stimer_task, item);
+	list_delete_item(&timer->item);
+	timer->kind = kind;
+	return timer;
+}
+
+static void timer_free(struct stimer_task *timer)
+{
+	struct stimer_ctx *ctx = timer->ctx;
+
+	list_delete_item(&timer->item);
+	timer->timer_f = NULL;
+	timer->arg = NULL;
+	list_add_tail(&ctx->timer_free, &timer->item);
+}
+
+/**
+ * @brief 软件定时器到期 先从时间轮中摘下再执行, 回调中可以重新启动定时器
+ * 
+ * @param timer 定时器
+ */
+static void timer_expire(struct stimer_task *timer)
+{
+	list_delete_item(&timer->item);
+
+	if (timer->kind == STIMER_KIND_DEFER) {
+		stimer_f f = timer->task_f;
+		timer_free(timer);
+		if (f)
+			f();
+	} else if (timer->timer_f) {
+		timer->timer_f(timer->arg);
+	}
+}
+
+/**
+ * @brief 同一节拍内 a 是否应先于 b 执行
+ * 
+ * @param a 
+ * @param b 
+ * @return bool 
+ */
+static inline bool stimer_task_before(const struct stimer_task *a, const struct stimer_task *b)
+{
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+
+	uint32_t da = a->expires + (a->deadline ? a->deadline : a->period);
+	uint32_t db = b->expires + (b->deadline ? b->deadline : b->period);
+
+	return (int32_t)(da - db) < 0;
+}
+
+/**
+ * @brief 按执行顺序将任务插入第0级时间轮的槽位
+ * 
+ * 从尾部向前查找, 优先级与截止时间都相同的任务直接追加到尾部
+ * 
+ * @param head 槽位
+ * @param task 任务
+ */
+static void wheel_insert_ordered(list_item *head, struct stimer_task *task)
+{
+	list_item *pos = head->pre;
+
+	while (pos != head && stimer_task_before(task, container_of(pos, struct stimer_task, item)))
+		pos = pos->pre;
+
+	list_add_tail(pos->next, &task->item);
+}
+
+/**
+ * @brief 按到期节拍将任务放入时间轮
+ * 
+ * @param task 任务
+ */
+static void wheel_add(struct stimer_task *task)
+{
+	struct stimer_ctx *ctx = task->ctx;
+	uint32_t base = ctx->pre_tick + 1; // 下一个待处理的节拍
+	uint32_t expires = task->expires;
+	uint32_t delta = expires - base;
+	uint8_t lv;
+
+	if ((int32_t)delta < 0) {
+		// 已经过期 放入下一个待处理的槽位
+		expires = base;
+		delta = 0;
+	} else if (delta >= STIMER_WHEEL_RANGE) {
+		// 超出时间轮范围 暂存于最高级, 级联时按真实的到期节拍重新放置
+		expires = base + STIMER_WHEEL_RANGE - 1;
+		delta = STIMER_WHEEL_RANGE - 1;
+	}
+
+	for (lv = 0; lv < STIMER_WHEEL_LEVELS - 1; lv++) {
+		if (delta < (1UL << ((lv + 1) * STIMER_WHEEL_BITS)))
+			break;
+	}
+
+	list_delete_item(&task->item);
+
+	// 只有第0级的槽位会被直接执行, 需要保持执行顺序
+	if (lv == 0)
+		wheel_insert_ordered(&ctx->wheel[lv][WHEEL_IDX(expires, lv)], task);
+	else
+		list_add_tail(&ctx->wheel[lv][WHEEL_IDX(expires, lv)], &task->item);
+
+	ctx->wheel_bitmap[lv] |= 1UL << WHEEL_IDX(expires, lv);
+}
+
+/**
+ * @brief 将高级时间轮当前槽位的任务重新分配到低级时间轮
+ * 
+ * @param ctx 调度器实例
+ * @param lv 时间轮级别
+ * @param tick 即将处理的节拍
+ */
+static void wheel_cascade(struct stimer_ctx *ctx, uint8_t lv, uint32_t tick)
+{
+	struct list_item *cur_item, *next_item;
+
+	uint32_t idx = WHEEL_IDX(tick, lv);
+
+	list_for_each_safe(cur_item, next_item, &ctx->wheel[lv][idx])
+	{
+		wheel_add(container_of(cur_item, struct stimer_task, item));
+	}
+	ctx->wheel_bitmap[lv] &= ~(1UL << idx);
+}
+
+/**
+ * @brief 分批级联高级时间轮中即将到达的槽位
+ * 
+ * 第 lv 级的下一个槽位在其起始节拍之前 STIMER_WHEEL_SIZE^(lv-1) 个节拍被摘下, 之后每个节拍最多级联
+ * STIMER_WHEEL_CASCADE_BUDGET 个任务, 到达起始节拍时处理剩余的全部任务
+ * 槽位中的任务最早在起始节拍到期, 提前级联时 wheel_add 按到期节拍与当前节拍的差值放置, 不会错过到期;
+ * 差值仍不小于本级跨度的任务(槽位末尾的任务)会回到原槽位, 在起始节拍随常规级联处理
+ * 
+ * @param ctx 调度器实例
+ * @param tick 即将处理的节拍
+ */
+static void wheel_cascade_ahead(struct stimer_ctx *ctx, uint32_t tick)
+{
+	for (uint8_t lv = 2; lv < STIMER_WHEEL_LEVELS; lv++) {
+		uint32_t lead = 1UL << ((lv - 1) * STIMER_WHEEL_BITS);
+		uint32_t start = tick + lead;
+
+		if (!(start & ((1UL << (lv * STIMER_WHEEL_BITS)) - 1))) {
+			uint32_t idx = WHEEL_IDX(start, lv);
+
+			list_splice_tail_init(&ctx->wheel_pend[lv], &ctx->wheel[lv][idx]);
+			ctx->wheel_bitmap[lv] &= ~(1UL << idx);
+			ctx->wheel_pend_end[lv] = start;
+		}
+
+		uint32_t budget = (tick == ctx->wheel_pend_end[lv]) ? UINT32_MAX : STIMER_WHEEL_CASCADE_BUDGET;
+
+		while (budget-- && !list_is_empty(&ctx->wheel_pend[lv]))
+			wheel_add(container_of(ctx->wheel_pend[lv].next, struct stimer_task, item));
+	}
+}
+
+/**
+ * @brief 查找时间轮中最近的到期节拍
+ * 
+ * 高级时间轮只能确定槽位的级联节拍, 以此作为到期节拍的下限, 级联后再重新计算即可
+ * 
+ * @param ctx 调度器实例
+ * @return uint32_t 距离下一个待处理节拍的节拍数, 时间轮为空时返回 STIMER_WHEEL_RANGE
+ */
+static uint32_t wheel_next_expiry(struct stimer_ctx *ctx)
+{
+	uint32_t base = ctx->pre_tick + 1;
+	uint32_t next = STIMER_WHEEL_RANGE;
+
+	for (uint8_t lv = 0; lv < STIMER_WHEEL_LEVELS; lv++) {
+		uint8_t shift = lv * STIMER_WHEEL_BITS;
+		uint32_t idx = WHEEL_IDX(base, lv);
+
+		// 高级时间轮的当前槽位只有恰好位于级联边界时才会立即级联, 否则要等转过一圈
+		uint32_t k = (base & ((1UL << shift) - 1)) ? 1 : 0;
+
+		for (; k <= STIMER_WHEEL_SIZE; k++) {
+			uint32_t slot = (idx + k) & STIMER_WHEEL_MASK;
+
+			if (!(ctx->wheel_bitmap[lv] & (1UL << slot)))
+				continue;
+
+			if (list_is_empty(&ctx->wheel[lv][slot])) {
+				ctx->wheel_bitmap[lv] &= ~(1UL << slot);
+				continue;
+			}
+
+			// 第0级为精确的到期节拍, 更高级为该槽位的级联节拍
+			uint32_t delta = (lv == 0) ? k : (((base >> shift) + k) << shift) - base;
+			if (delta < next)
+				next = delta;
+			break;
+		}
+
+		// 分批级联中的任务最早在该槽位的起始节拍到期
+		if (!list_is_empty(&ctx->wheel_pend[lv]) && ctx->wheel_pend_end[lv] - base < next)
+			next = ctx->wheel_pend_end[lv] - base;
+	}
+
+	return next;
+}
+
+/**
+ * @brief 修改任务的实际周期
+ * 
+ * 新周期比距离下一次释放的时间更短时从当前节拍起按新周期释放, 保证缩短周期立即生效
+ * 
+ * @param task 周期任务
+ * @param period 新周期(节拍)
+ */
+static void stimer_task_apply_period(struct stimer_task *task, uint32_t period)
+{
+	task->period = period;
+
+	if (task->suspended)
+		return;
+
+	uint32_t next = task->ctx->pre_tick + period;
+	if ((int32_t)(task->expires - next) > 0) {
+		task->expires = next;
+		wheel_add(task);
+	}
+}
+
+#if STIMER_ENABLE_GOVERNOR
+/**
+ * @brief 计算任务在指定降级等级下的周期
+ * 
+ * @param task 周期任务
+ * @param level 降级等级
+ * @return uint32_t 周期(节拍)
+ */
+static uint32_t stimer_task_shed_period(struct stimer_task *task, uint8_t level)
+{
+	while (level) {
+		if (task->shed_period[level - 1])
+			return task->shed_period[level - 1];
+		level--;
+	}
+
+	return task->base_period;
+}
+#endif
+
+static bool stimer_task_add(struct stimer_task *p_task)
+{
+	if (!p_task)
+		return false;
+
+	// 事件任务不进入时间轮
+	if (!p_task->period)
+		return true;
+
+	p_task->expires = p_task->ctx->pre_tick + p_task->period;
+	wheel_add(p_task);
+	return true;
+}
+
+#if STIMER_ENABLE_STAGGER
+static uint32_t stimer_gcd(uint32_t a, uint32_t b)
+{
+	while (b) {
+		uint32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief 任务每次执行的耗时估计, 用于错峰
+ * 
+ * @param task 周期任务
+ * @return uint32_t 执行时间,单位微秒 至少为1
+ */
+static uint32_t stimer_task_weight(struct stimer_task *task)
+{
+	if (task->wcet_us)
+		return task->wcet_us;
+
+#if STIMER_ENABLE_PROFILE
+	if (task->prof.count) {
+		uint32_t avg = PROF_CYCLE_TO_US(task->ctx, task->prof.exec_sum / task->prof.count);
+		if (avg)
+			return avg;
+	}
+#endif
+
+	return 1;
+}
+
+/**
+ * @brief 错峰放置新建的周期任务
+ * 
+ * 负载表按 节拍 % STIMER_STAGGER_SLOTS 划分槽位, 周期为 P 的任务只会落在间隔为 g = gcd(P, 槽位数) 的槽位上,
+ * 平均每经过一次槽位执行 g / P 次, 因此其负载按 执行时间 * g / P 计入这些槽位(放大256倍保留小数)
+ * 新任务的首次释放在 [pre_tick + P - g + 1, pre_tick + P] 中选择, 这 g 个候选覆盖了所有可能的槽位组合,
+ * 选择所经槽位的最大负载最小者, 其次总负载最小者, 都相同时取最晚的候选(即未错峰时的释放节拍)
+ * 
+ * @param task 新建的周期任务, 尚未加入任务链表
+ */
+static void stimer_task_stagger(struct stimer_task *task)
+{
+	struct stimer_ctx *ctx = task->ctx;
+	struct list_item *cur_item, *next_item;
+	uint32_t load[STIMER_STAGGER_SLOTS] = { 0 };
+	uint32_t best_max = UINT32_MAX, best_sum = UINT32_MAX;
+	uint32_t g = stimer_gcd(task->period, STIMER_STAGGER_SLOTS);
+	uint32_t step = task->period % STIMER_STAGGER_SLOTS;
+	uint32_t latest = ctx->pre_tick + task->period;
+
+	task->expires = latest;
+
+	list_for_each_safe(cur_item, next_item, &ctx->task_list)
+	{
+		struct stimer_task *other = container_of(cur_item, struct stimer_task, node);
+
+		if (!other->period || other->suspended || other->kind == STIMER_KIND_FAST)
+			continue;
+
+		uint32_t og = stimer_gcd(other->period, STIMER_STAGGER_SLOTS);
+		uint32_t ostep = other->period % STIMER_STAGGER_SLOTS;
+		uint32_t slot = other->expires % STIMER_STAGGER_SLOTS;
+		uint32_t w = (uint32_t)((uint64_t)stimer_task_weight(other) * og * 256 / other->period);
+
+		for (uint32_t n = 0; n < STIMER_STAGGER_SLOTS / og; n++) {
+			load[slot] += w;
+			slot = (slot + ostep) % STIMER_STAGGER_SLOTS;
+		}
+	}
+
+	for (uint32_t i = 0; i < g; i++) {
+		uint32_t first = latest - i;
+		uint32_t slot = first % STIMER_STAGGER_SLOTS;
+		uint32_t max = 0, sum = 0;
+
+		for (uint32_t n = 0; n < STIMER_STAGGER_SLOTS / g; n++) {
+			if (load[slot] > max)
+				max = load[slot];
+			sum += load[slot];
+			slot = (slot + step) % STIMER_STAGGER_SLOTS;
+		}
+
+		if (max < best_max || (max == best_max && sum < best_sum)) {
+			best_max = max;
+			best_sum = sum;
+			task->expires = first;
+		}
+	}
+
+	wheel_add(task);
+}
+#endif /* STIMER_ENABLE_STAGGER */
+
+/**
+ * @brief 处理一次到期的释放, 按错过释放的策略计算下次到期节拍并重新入轮
+ * 
+ * @param task 到期的任务
+ * @param now 当前实际节拍
+ * @return bool 本次是否需要执行任务
+ */
+static bool stimer_task_release(struct stimer_task *task, uint32_t now)
+{
+	uint32_t lag = now - task->expires;	  // 距离释放节拍已经过去的节拍数
+	uint32_t missed = lag / task->period; // 除本次外已经错过的释放次数
+	bool run = true;
+
+	if (lag) {
+		++task->stat.late;
+		if (lag > task->stat.max_lag)
+			task->stat.max_lag = lag;
+	}
+
+	if (missed == 0 || task->overrun == STIMER_OVERRUN_CATCH_UP) {
+		task->expires += task->period;
+	} else if (task->overrun == STIMER_OVERRUN_SKIP) {
+		task->stat.lost += missed + 1;
+		task->expires += (missed + 1) * task->period;
+		run = false;
+	} else {
+		task->stat.lost += missed;
+		task->expires += (missed + 1) * task->period;
+	}
+
+	wheel_add(task);
+
+	if (run)
+		++task->stat.runs;
+
+	return run;
+}
+
+static uint32_t inline stimer_get_tick(struct stimer_ctx *ctx)
+{
+	return ctx->cur_tick + ctx->idle_tick;
+}
+
+/**
+ * @brief 节拍计数距离基准较远时更新64位计数的基准 只在主循环中调用
+ * 
+ * @param ctx 调度器实例
+ * @param now 当前节拍
+ */
+static void stimer_epoch_update(struct stimer_ctx *ctx, uint32_t now)
+{
+	const struct stimer_epoch *cur = &ctx->epoch[ctx->epoch_idx];
+	uint32_t delta = now - cur->lo;
+
+	if (delta < STIMER_EPOCH_SPAN)
+		return;
+
+	struct stimer_epoch *next = &ctx->epoch[!ctx->epoch_idx];
+	uint64_t tick = (((uint64_t)cur->hi << 32) | cur->lo) + delta;
+
+	next->lo = (uint32_t)tick;
+	next->hi = (uint32_t)(tick >> 32);
+	__atomic_store_n(&ctx->epoch_idx, !ctx->epoch_idx, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 获取64位节拍计数 可在中断中调用
+ * 
+ * @param ctx 调度器实例
+ * @return uint64_t 节拍计数
+ */
+static uint64_t stimer_get_tick64(struct stimer_ctx *ctx)
+{
+	// 先读基准再读节拍, 保证节拍不早于基准
+	struct stimer_epoch base = ctx->epoch[__atomic_load_n(&ctx->epoch_idx, __ATOMIC_ACQUIRE)];
+	uint32_t now = stimer_get_tick(ctx);
+
+	return (((uint64_t)base.hi << 32) | base.lo) + (uint32_t)(now - base.lo);
+}
+
+/**
+ * @brief 获取实例的当前时间 可在中断中调用
+ * 
+ * @param ctx 调度器实例
+ * @return uint64_t 微秒数
+ */
+static uint64_t stimer_time_us(struct stimer_ctx *ctx)
+{
+	uint64_t tick;
+	uint32_t sub;
+
+	// 读取节拍内插值期间发生了节拍中断时重新读取
+	do {
+		tick = stimer_get_tick64(ctx);
+		sub = ctx->f_get_subtick ? ctx->f_get_subtick() : 0;
+	} while (tick != stimer_get_tick64(ctx));
+
+	return tick * STIMER_TICK_US + sub;
+}
+
+#if STIMER_ENABLE_BUDGET
+/**
+ * @brief 读取执行时间的计时起点
+ * 
+ * 移植接口提供了 f_get_cycle 时读取自由运行计数器, 精度为一个计数;
+ * 否则读取 stimer_time_us, 精度取决于 f_get_subtick, 未提供时为一个节拍
+ * 
+ * @param ctx 调度器实例
+ * @return uint64_t 计数值或微秒数 只用于 budget_elapsed_us
+ */
+static inline uint64_t budget_stamp(struct stimer_ctx *ctx)
+{
+	if (ctx->f_get_cycle && ctx->cycle_per_us)
+		return ctx->f_get_cycle();
+
+	return stimer_time_us(ctx);
+}
+
+/**
+ * @brief 计算自计时起点以来经过的时间
+ * 
+ * 计数器为32位, 单次执行时间不能超过计数器的一个回绕周期
+ * 
+ * @param ctx 调度器实例
+ * @param begin budget_stamp 的返回值
+ * @return uint32_t 微秒数
+ */
+static inline uint32_t budget_elapsed_us(struct stimer_ctx *ctx, uint64_t begin)
+{
+	if (ctx->f_get_cycle && ctx->cycle_per_us)
+		return (ctx->f_get_cycle() - (uint32_t)begin) / ctx->cycle_per_us;
+
+	return (uint32_t)(stimer_time_us(ctx) - begin);
+}
+
+/**
+ * @brief 记录任务的执行时间, 超出声明的执行时间时按钩子函数的返回值处理
+ * 
+ * @param task 任务
+ * @param exec_us 本次执行时间,单位微秒
+ */
+static void stimer_task_budget(struct stimer_task *task, uint32_t exec_us)
+{
+	struct stimer_ctx *ctx = task->ctx;
+
+	if (exec_us > task->wcet_max_us)
+		task->wcet_max_us = exec_us;
+
+	if (!task->wcet_us || exec_us <= task->wcet_us)
+		return;
+
+	++task->stat.budget_overrun;
+
+	if (!ctx->budget_hook)
+		return;
+
+	switch (ctx->budget_hook(task, exec_us)) {
+	case STIMER_BUDGET_SKIP:
+		// 事件任务没有下一次释放
+		if (task->period && !task->suspended) {
+			++task->stat.lost;
+			task->expires += task->period;
+			wheel_add(task);
+		}
+		break;
+	case STIMER_BUDGET_DEMOTE:
+		task->priority = 0;
+		break;
+	default:
+		break;
+	}
+}
+#endif /* STIMER_ENABLE_BUDGET */
+
+/**
+ * @brief 执行任务
+ * 
+ * @param task 任务
+ * @param release 本次的释放节拍
+ */
+static void stimer_task_run(struct stimer_task *task, uint32_t release)
+{
+	struct stimer_ctx *ctx = task->ctx;
+
+	if (!task->task_f)
+		return;
+
+	ctx->current = task;
+
+	if (ctx->f_trace)
+		ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_START, stimer_get_tick(ctx));
+
+#if STIMER_ENABLE_BUDGET
+	uint64_t begin = budget_stamp(ctx);
+#endif
+
+#if STIMER_ENABLE_PROFILE
+	uint32_t start = prof_get_cycle(ctx);
+	uint32_t latency = start - prof_release_cycle(ctx, release);
+
+	task->task_f();
+
+	if (ctx->f_get_cycle)
+		prof_record(task, latency, prof_get_cycle(ctx) - start);
+#else
+	(void)release;
+	task->task_f();
+#endif
+
+#if STIMER_ENABLE_BUDGET
+	stimer_task_budget(task, budget_elapsed_us(ctx, begin));
+#endif
+
+	if (ctx->f_trace)
+		ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_END, stimer_get_tick(ctx));
+
+	ctx->current = NULL;
+}
+
+/**
+ * @brief 向投递队列写入一项 可在中断中调用
+ * 
+ * @param ctx 调度器实例
+ * @param f 工作函数 为NULL时 arg 为被通知的任务
+ * @param arg 参数
+ * @return bool 队列已满返回false
+ */
+static bool stimer_work_post(struct stimer_ctx *ctx, stimer_work_f f, void *arg)
+{
+	uint32_t wr = __atomic_load_n(&ctx->work_wr, __ATOMIC_RELAXED);
+
+	do {
+		if (wr - __atomic_load_n(&ctx->work_rd, __ATOMIC_ACQUIRE) >= STIMER_WORK_QUEUE_SIZE)
+			return false;
+	} while (!__atomic_compare_exchange_n(&ctx->work_wr, &wr, wr + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	struct stimer_work *work = &ctx->work[wr & STIMER_WORK_MASK];
+	work->f = f;
+	work->arg = arg;
+	__atomic_store_n(&work->seq, wr + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/**
+ * @brief 执行投递队列中的工作与被通知的任务
+ * 
+ * 每次最多处理一个队列容量的数量, 避免中断持续投递时节拍得不到处理
+ * 
+ * @param ctx 调度器实例
+ */
+static void stimer_work_run(struct stimer_ctx *ctx)
+{
+	uint32_t rd = ctx->work_rd;
+
+	for (uint32_t n = 0; n < STIMER_WORK_QUEUE_SIZE; n++) {
+		struct stimer_work *work = &ctx->work[rd & STIMER_WORK_MASK];
+
+		// 生产者尚未写完或队列为空
+		if (__atomic_load_n(&work->seq, __ATOMIC_ACQUIRE) != rd + 1)
+			break;
+
+		stimer_work_f f = work->f;
+		void *arg = work->arg;
+		__atomic_store_n(&ctx->work_rd, ++rd, __ATOMIC_RELEASE);
+
+		if (f) {
+			f(arg);
+			continue;
+		}
+
+		// 先清除通知标志, 执行期间的新通知会再次入队
+		struct stimer_task *task = (struct stimer_task *)arg;
+		__atomic_store_n(&task->pending, 0, __ATOMIC_RELEASE);
+		if (task->suspended)
+			continue;
 
-#define STIMER_TASK_HIT_LIST_MAX (32)
-#define MAX_DEFER_TASK (16)
+		++task->stat.runs;
+		stimer_task_run(task, stimer_get_tick(ctx));
+	}
+}
+
+/**
+ * @brief 是否有尚未执行的投递
+ * 
+ * @param ctx 调度器实例
+ * @return bool 
+ */
+static inline bool stimer_work_queued(struct stimer_ctx *ctx)
+{
+	return __atomic_load_n(&ctx->work_wr, __ATOMIC_ACQUIRE) != __atomic_load_n(&ctx->work_rd, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief 计算距离最近一个到期任务的节拍数
+ * 
+ * @param ctx 调度器实例
+ * @return uint32_t 节拍数, 至少为1
+ */
+static uint32_t stimer_next_deadline(struct stimer_ctx *ctx)
+{
+	return wheel_next_expiry(ctx) + 1;
+}
+
+/**
+ * @brief 没有待处理的节拍时进入休眠
+ * 
+ * @param ctx 调度器实例
+ */
+static void stimer_idle(struct stimer_ctx *ctx)
+{
+	// 检查之后到来的节拍或投递在此再确认一次, 否则要等到单次唤醒才会处理
+	if (!ctx->f_idle || stimer_work_queued(ctx) || ctx->pre_tick != stimer_get_tick(ctx))
+		return;
+
+#if STIMER_MAX_FAST_TASK > 0
+	// 快速任务依赖周期节拍
+	if (ctx->f_wakeup && !ctx->fast_num) {
+#else
+	if (ctx->f_wakeup) {
+#endif
+		uint32_t ticks = stimer_next_deadline(ctx);
+
+		// 下一个节拍就有任务到期时无需暂停周期节拍
+		if (ticks > 1)
+			ctx->f_wakeup(ticks);
+	}
+
+	ctx->idle_tick += ctx->f_idle();
+}
+
+#if STIMER_ENABLE_GOVERNOR
+/**
+ * @brief 统计窗口结束时根据负载率调整降级等级, 并更新所有周期任务的周期
+ * 
+ * @param ctx 调度器实例
+ */
+static void stimer_governor_update(struct stimer_ctx *ctx)
+{
+	struct list_item *cur_item, *next_item;
+	uint32_t now = stimer_get_tick(ctx);
+
+	if (now - ctx->gov_tick < Period_to_Tick(STIMER_GOVERNOR_WINDOW_MS))
+		return;
+
+	uint64_t total = ctx->gov_busy + ctx->gov_idle;
+	uint32_t usage = total ? (uint32_t)(ctx->gov_busy * 1000 / total) : 0;
+	uint8_t level = ctx->shed_level;
+
+	ctx->gov_tick = now;
+	ctx->gov_busy = 0;
+	ctx->gov_idle = 0;
+
+	if (usage > STIMER_GOVERNOR_HIGH && level < STIMER_SHED_LEVELS)
+		level++;
+	else if (usage < STIMER_GOVERNOR_LOW && level > 0)
+		level--;
+
+	if (level == ctx->shed_level)
+		return;
+
+	ctx->shed_level = level;
+
+	list_for_each_safe(cur_item, next_item, &ctx->task_list)
+	{
+		struct stimer_task *task = container_of(cur_item, struct stimer_task, node);
+		if (task->period && task->kind == STIMER_KIND_TASK)
+			stimer_task_apply_period(task, stimer_task_shed_period(task, level));
+	}
+}
+#endif /* STIMER_ENABLE_GOVERNOR */
+
+static void stimer_task_dispatch(struct stimer_ctx *ctx)
+{
+	struct stimer_task *task;
+	list_item expired;
+	uint32_t now = stimer_get_tick(ctx);
+
+	if (!is_timer_run(ctx) || (ctx->pre_tick == now))
+		return;
+
+	stimer_epoch_update(ctx, now);
+
+	uint32_t tick = ctx->pre_tick + 1;
+
+	wheel_cascade_ahead(ctx, tick);
+
+	// 低级时间轮转过一圈, 逐级向下级联
+	for (uint8_t lv = 1; lv < STIMER_WHEEL_LEVELS; lv++) {
+		if (WHEEL_IDX(tick, lv - 1) != 0)
+			break;
+		wheel_cascade(ctx, lv, tick);
+	}
+
+	ctx->pre_tick = tick;
+
+	// 先摘下当前槽位 防止周期恰好为一圈的任务被重新放回本槽位
+	list_init(&expired);
+	list_splice_tail_init(&expired, &ctx->wheel[0][WHEEL_IDX(tick, 0)]);
+	ctx->wheel_bitmap[0] &= ~(1UL << WHEEL_IDX(tick, 0));
+
+	// 每次从头部取出 每个节点处理时都会离开本链表(重新入轮或摘下)
+	// 执行中停止或重新启动了同一节拍到期的其他定时器/任务时, 它们也会离开本链表, 遍历不受影响
+	while (!list_is_empty(&expired)) {
+		task = container_of(expired.next, struct stimer_task, item);
+
+		if (task->kind != STIMER_KIND_TASK) {
+			timer_expire(task);
+			continue;
+		}
+
+		uint32_t release = task->expires;
+		if (ctx->f_trace)
+			ctx->f_trace(ctx->trace_arg, task, STIMER_TRACE_RELEASE, release);
+		if (stimer_task_release(task, now))
+			stimer_task_run(task, release);
+	}
+}
+
+/**
+ * @brief 按参数计算任务周期
+ * 
+ * @param attr 任务参数
+ * @return uint32_t 周期(节拍) 事件任务为0
+ */
+static uint32_t stimer_attr_period(const struct stimer_task_attr *attr)
+{
+	if (attr->period_us)
+		return Us_to_Tick(attr->period_us);
 
-#define Period_to_Tick(p) (((p) >= STIMER_PERIOD_PER_TICK_MS) ? ((p) / STIMER_PERIOD_PER_TICK_MS) : 1U)
+	return attr->period_ms ? Period_to_Tick(attr->period_ms) : 0;
+}
 
-struct stimer_task {
-	stimer_f task_f;
-	uint32_t period;
-	uint32_t arrive;
-	list_item item;
-	uint8_t reserved;
+#if STIMER_ENABLE_BUDGET
+/**
+ * @brief 可调度性分析中的一个任务 时间单位均为微秒
+ */
+struct stimer_sched_item {
+	uint32_t wcet;
+	uint64_t period;   // 0表示事件任务
+	uint64_t deadline; // 相对截止时间
+	bool fast;		   // 快速任务 抢占主循环, 不会阻塞其他任务
 };
 
-struct timer {
-	volatile uint32_t pre_tick;
-	volatile uint32_t cur_tick;
-	volatile int run_flag;
-	stimer_base_start f_start;
-	list_item long_tick_list;
-	list_item hit_task_list[STIMER_TASK_HIT_LIST_MAX];
-	list_item defer_task_list;
+static struct stimer_sched_item stimer_sched_item_of(struct stimer_task *task)
+{
+	uint32_t deadline = task->deadline ? task->deadline : task->period;
+
+	return (struct stimer_sched_item){
+		.wcet = task->wcet_us ? task->wcet_us : task->wcet_max_us,
+		.period = (uint64_t)task->period * STIMER_TICK_US,
+		.deadline = (uint64_t)deadline * STIMER_TICK_US,
+		.fast = task->kind == STIMER_KIND_FAST,
+	};
+}
+
+// 可调度性分析的中间结果
+struct stimer_sched_state {
+	uint64_t util; // 总利用率 百万分比
+	uint32_t max1; // 最长的执行时间
+	uint32_t max2; // 次长的执行时间
+	bool pass;	   // 阻塞检查是否通过
 };
 
-static struct stimer_task defer_pool[MAX_DEFER_TASK];
-static struct timer m_timer = { 0 };
+/**
+ * @brief 将一个任务计入可调度性分析
+ * 
+ * @param state 中间结果
+ * @param item 任务
+ * @param round 0: 统计利用率与最长的两个执行时间 1: 检查阻塞
+ */
+static void stimer_sched_account(struct stimer_sched_state *state, const struct stimer_sched_item *item, uint8_t round)
+{
+	if (round == 0) {
+		if (item->period)
+			state->util += (uint64_t)item->wcet * 1000000 / item->period;
+
+		if (item->fast)
+			return;
+
+		if (item->wcet > state->max1) {
+			state->max2 = state->max1;
+			state->max1 = item->wcet;
+		} else if (item->wcet > state->max2) {
+			state->max2 = item->wcet;
+		}
+	} else if (item->period && !item->fast) {
+		uint32_t block = (item->wcet == state->max1) ? state->max2 : state->max1;
+
+		if ((uint64_t)item->wcet + block > item->deadline)
+			state->pass = false;
+	}
+}
 
-static inline int is_timer_run(void)
+/**
+ * @brief 对实例中的任务(以及一个待创建的任务)做可调度性分析
+ * 
+ * 任务之间不会抢占, 因此除总利用率外, 每个周期任务还可能被已开始执行的最长任务阻塞:
+ * 1. 所有周期任务的 执行时间 / 周期 之和不超过 STIMER_UTIL_LIMIT
+ * 2. 每个周期任务的 执行时间 + 其他任务中最长的执行时间 不超过其相对截止时间
+ * 执行时间取声明的 wcet_us, 未声明时取运行中测得的最大值
+ * 
+ * @param ctx 调度器实例
+ * @param extra 待创建的任务 可为NULL
+ * @param info 输出分析结果
+ */
+static void stimer_sched_analyze(
+	struct stimer_ctx *ctx, const struct stimer_sched_item *extra, struct stimer_sched_info *info)
 {
-	return m_timer.run_flag == 1;
+	struct list_item *cur_item, *next_item;
+	struct stimer_sched_state state = { .pass = true };
+
+	for (uint8_t round = 0; round < 2; round++) {
+		list_for_each_safe(cur_item, next_item, &ctx->task_list)
+		{
+			struct stimer_task *task = container_of(cur_item, struct stimer_task, node);
+			if (task->suspended)
+				continue;
+
+			struct stimer_sched_item item = stimer_sched_item_of(task);
+			stimer_sched_account(&state, &item, round);
+		}
+
+		if (extra)
+			stimer_sched_account(&state, extra, round);
+	}
+
+	info->utilization = (uint32_t)((state.util + 999) / 1000);
+	info->max_wcet_us = state.max1;
+	info->schedulable = state.pass && info->utilization <= STIMER_UTIL_LIMIT;
 }
 
-static inline void _timer_update(void)
+/**
+ * @brief 创建任务前的准入检查
+ * 
+ * @param ctx 调度器实例
+ * @param attr 任务参数
+ * @return bool 可以创建返回true
+ */
+static bool stimer_task_admit(struct stimer_ctx *ctx, const struct stimer_task_attr *attr)
 {
-	++m_timer.cur_tick;
+	struct stimer_sched_info info;
+	uint32_t period = stimer_attr_period(attr);
+	uint32_t deadline = attr->deadline_ms ? Period_to_Tick(attr->deadline_ms) : period;
+	struct stimer_sched_item item = {
+		.wcet = attr->wcet_us,
+		.period = (uint64_t)period * STIMER_TICK_US,
+		.deadline = (uint64_t)deadline * STIMER_TICK_US,
+		.fast = attr->tier == STIMER_TIER_FAST,
+	};
+
+	stimer_sched_analyze(ctx, &item, &info);
+
+	return info.schedulable || !STIMER_ADMISSION_REJECT;
 }
+#endif /* STIMER_ENABLE_BUDGET */
 
-static struct stimer_task *defer_task_allocate(void)
+/**
+ * @brief 检查任务的执行层级是否可用
+ * 
+ * @param ctx 调度器实例
+ * @param attr 任务参数
+ * @return bool 可用返回true
+ */
+static bool stimer_task_tier_valid(struct stimer_ctx *ctx, const struct stimer_task_attr *attr)
 {
-	for (int i = 0; i < MAX_DEFER_TASK; i++) {
-		if (defer_pool[i].reserved == 1)
-			return &defer_pool[i];
-	}
-	return NULL;
+	if (attr->tier == STIMER_TIER_NORMAL)
+		return true;
+
+#if STIMER_MAX_FAST_TASK > 0
+	return attr->tier == STIMER_TIER_FAST && stimer_attr_period(attr) && attr->wcet_us <= STIMER_FAST_MAX_US &&
+		ctx->fast_num < STIMER_MAX_FAST_TASK;
+#else
+	(void)ctx;
+	return false;
+#endif
 }
 
-static void defer_task_free(struct stimer_task *task)
+/**
+ * @brief 按参数初始化已清零的任务控制块, 并放入时间轮与任务链表
+ * 
+ * @param ctx 调度器实例
+ * @param task 任务控制块
+ * @param attr 任务参数
+ */
+static void stimer_task_setup(struct stimer_ctx *ctx, struct stimer_task *task, const struct stimer_task_attr *attr)
 {
-	if (task) {
-		task->task_f = NULL;
-		task->reserved = 1;
-		task->arrive = 0;
-		task->period = 0;
+	task->ctx = ctx;
+	task->period = stimer_attr_period(attr);
+	task->kind = STIMER_KIND_TASK;
+	task->task_f = attr->task_f;
+	task->overrun = attr->overrun;
+	task->name = attr->name;
+	task->arg = attr->arg;
+	task->priority = attr->priority;
+	task->deadline = attr->deadline_ms ? Period_to_Tick(attr->deadline_ms) : 0;
+#if STIMER_ENABLE_GOVERNOR
+	task->base_period = task->period;
+	for (uint8_t i = 0; i < STIMER_SHED_LEVELS; i++)
+		task->shed_period[i] = attr->shed_period_ms[i] ? Period_to_Tick(attr->shed_period_ms[i]) : 0;
+	if (task->period && attr->tier != STIMER_TIER_FAST)
+		task->period = stimer_task_shed_period(task, ctx->shed_level);
+#endif
+	task->wcet_us = attr->wcet_us;
+	list_init(&(task->item));
+
+#if STIMER_MAX_FAST_TASK > 0
+	if (attr->tier == STIMER_TIER_FAST) {
+		// 初始化完成后再发布给节拍中断
+		task->kind = STIMER_KIND_FAST;
+		task->expires = ctx->cur_tick + task->period;
+		ctx->fast[ctx->fast_num] = task;
+		__atomic_store_n(&ctx->fast_num, ctx->fast_num + 1, __ATOMIC_RELEASE);
+		list_add_tail(&(ctx->task_list), &(task->node));
+		return;
 	}
+#endif
+
+#if STIMER_ENABLE_STAGGER
+	if (task->period && !attr->no_stagger)
+		stimer_task_stagger(task);
+	else
+		stimer_task_add(task);
+#else
+	stimer_task_add(task);
+#endif
+	list_add_tail(&(ctx->task_list), &(task->node));
 }
 
-static inline void _add_timer(uint32_t period, list_item *item)
+/**
+ * @brief 初始化调度器实例的链表与软件定时器池
+ * 
+ * @param ctx 调度器实例
+ */
+static void stimer_ctx_init(struct stimer_ctx *ctx)
 {
-	list_delete_item(item);
+	list_init(&(ctx->timer_free));
+	list_init(&(ctx->task_list));
 
-	if (period > STIMER_TASK_HIT_LIST_MAX)
-		list_add_tail(&(m_timer.long_tick_list), item);
-	else
-		list_add_tail(&(m_timer.hit_task_list[HIT_LIST_IDX(period)]), item);
+	for (int i = 0; i < STIMER_MAX_TIMER; i++) {
+		ctx->timer_pool[i] = (struct stimer_task){ .kind = STIMER_KIND_TIMER, .ctx = ctx };
+		list_add_tail(&(ctx->timer_free), &(ctx->timer_pool[i].item));
+	}
+
+	for (uint8_t lv = 0; lv < STIMER_WHEEL_LEVELS; lv++) {
+		for (uint32_t i = 0; i < STIMER_WHEEL_SIZE; i++)
+			list_init(&(ctx->wheel[lv][i]));
+		list_init(&(ctx->wheel_pend[lv]));
+	}
 }
 
-static bool stimer_task_add(struct stimer_task *p_task)
+/*************************************API*************************************/
+
+bool stimer_init(struct timer_port *port)
 {
-	if (!p_task)
+	struct stimer_ctx *ctx = &m_timer;
+
+	if (!port || !port->f_start)
 		return false;
 
-	p_task->arrive = 0;
-	_add_timer(p_task->period, &(p_task->item));
+	// 节拍小于1毫秒时无法以毫秒为单位初始化定时器
+	if (!port->f_init_us && (!port->f_init || STIMER_TICK_US % 1000))
+		return false;
+
+	stimer_ctx_init(ctx);
+
+	if (port->f_init_us)
+		port->f_init_us(STIMER_TICK_US, _timer_update);
+	else
+		port->f_init(STIMER_PERIOD_PER_TICK_MS, _timer_update);
+	ctx->f_start = port->f_start;
+	ctx->f_wakeup = port->f_wakeup;
+	ctx->f_idle = port->f_idle;
+	ctx->f_get_subtick = port->f_get_subtick;
+
+#if STIMER_ENABLE_PROFILE || STIMER_ENABLE_BUDGET
+	ctx->f_get_cycle = port->f_get_cycle;
+	ctx->cycle_per_us = port->cycle_per_us;
+#endif
 	return true;
 }
 
-static uint32_t inline stimer_get_tick(void)
+struct stimer_ctx *stimer_ctx_create(void)
 {
-	return m_timer.cur_tick;
+	struct stimer_ctx *ctx = (struct stimer_ctx *)calloc(1, sizeof(struct stimer_ctx));
+	if (!ctx)
+		return NULL;
+
+	stimer_ctx_init(ctx);
+	ctx->run_flag = 1;
+	return ctx;
 }
 
-static void stimer_task_dispatch(void)
+void stimer_ctx_destroy(struct stimer_ctx *ctx)
 {
-	uint32_t idx, remain;
 	struct list_item *cur_item, *next_item;
-	struct stimer_task *task;
 
-	if (!is_timer_run() || (m_timer.pre_tick == m_timer.cur_tick))
+	if (!ctx || ctx == &m_timer)
 		return;
 
-	++m_timer.pre_tick;
-	idx = HIT_LIST_IDX(0);
+	list_for_each_safe(cur_item, next_item, &ctx->task_list)
+	{
+		struct stimer_task *task = container_of(cur_item, struct stimer_task, node);
+		if (!task->is_static)
+			free(task);
+	}
+
+	free(ctx);
+}
 
-	if (idx == 0) {
-		list_for_each_safe(cur_item, next_item, &(m_timer.long_tick_list))
-		{
-			task = container_of(cur_item, struct stimer_task, item);
-			task->arrive += STIMER_TASK_HIT_LIST_MAX;
-			remain = task->period - task->arrive;
-
-			if (remain == 0) {
-				if (task->task_f)
-					task->task_f();
-				task->arrive = 0;
-			} else if (remain < STIMER_TASK_HIT_LIST_MAX) {
-				_add_timer(remain, cur_item);
-			}
+void stimer_ctx_step(struct stimer_ctx *ctx, uint32_t ticks)
+{
+	if (!ctx)
+		return;
+
+	uint32_t end = stimer_get_tick(ctx) + ticks;
+
+	while ((int32_t)(end - stimer_get_tick(ctx)) > 0) {
+		// 任务中推进了节拍时(stimer_ctx_advance)已处理的节拍落后于当前节拍, 与主循环一样先逐拍补齐
+		if (!is_timer_run(ctx) || ctx->pre_tick == stimer_get_tick(ctx)) {
+			++ctx->cur_tick;
+#if STIMER_MAX_FAST_TASK > 0
+			stimer_fast_dispatch(ctx);
+#endif
 		}
+		stimer_work_run(ctx);
+		stimer_task_dispatch(ctx);
 	}
+}
 
-	list_for_each_safe(cur_item, next_item, &(m_timer.hit_task_list[idx]))
-	{
-		task = container_of(cur_item, struct stimer_task, item);
-		if (task->task_f)
-			task->task_f();
-		task->arrive = -idx;
-		_add_timer(task->period, &(task->item));
-	}
+void stimer_ctx_advance(struct stimer_ctx *ctx, uint32_t ticks)
+{
+	if (!ctx)
+		return;
 
-	list_for_each_safe(cur_item, next_item, &(m_timer.defer_task_list))
-	{
-		task = container_of(cur_item, struct stimer_task, item);
-		if (++task->arrive >= task->period) {
-			if (task->task_f)
-				task->task_f();
-			list_delete_item(cur_item);
-			defer_task_free(task);
-		}
+	while (ticks--) {
+		++ctx->cur_tick;
+#if STIMER_MAX_FAST_TASK > 0
+		stimer_fast_dispatch(ctx);
+#endif
 	}
 }
 
-/*************************************API*************************************/
+void stimer_ctx_set_trace(struct stimer_ctx *ctx, stimer_trace_f f, void *arg)
+{
+	if (!ctx || ctx == &m_timer)
+		return;
 
-bool stimer_init(struct timer_port *port)
+	ctx->trace_arg = arg;
+	ctx->f_trace = f;
+}
+
+uint32_t stimer_ctx_get_tick(struct stimer_ctx *ctx)
+{
+	return ctx ? stimer_get_tick(ctx) : 0;
+}
+
+uint64_t stimer_ctx_now_us(struct stimer_ctx *ctx)
+{
+	return ctx ? stimer_time_us(ctx) : 0;
+}
+
+stimer_handle stimer_ctx_task_create(struct stimer_ctx *ctx, const struct stimer_task_attr *attr)
+{
+	if (!ctx || !attr)
+		return NULL;
+
+	if (attr->init_f)
+		attr->init_f();
+
+	if (!attr->task_f || attr->overrun > STIMER_OVERRUN_COALESCE || !stimer_task_tier_valid(ctx, attr))
+		return NULL;
+
+#if STIMER_ENABLE_BUDGET
+	if (!stimer_task_admit(ctx, attr))
+		return NULL;
+#endif
+
+	struct stimer_task *task = (struct stimer_task *)calloc(1, sizeof(struct stimer_task));
+	if (task)
+		stimer_task_setup(ctx, task, attr);
+
+	return task;
+}
+
+stimer_timer_handle stimer_ctx_timer_create(struct stimer_ctx *ctx, stimer_work_f f, void *arg)
+{
+	if (!ctx || !f)
+		return NULL;
+
+	struct stimer_task *timer = timer_allocate(ctx, STIMER_KIND_TIMER);
+	if (!timer)
+		return NULL;
+
+	timer->timer_f = f;
+	timer->arg = arg;
+	return timer;
+}
+
+bool stimer_ctx_work_submit(struct stimer_ctx *ctx, stimer_work_f f, void *arg)
 {
-	if (!port || !port->f_init || !port->f_start)
+	if (!ctx || !f)
 		return false;
 
-	list_init(&(m_timer.long_tick_list));
-	list_init(&(m_timer.defer_task_list));
+	return stimer_work_post(ctx, f, arg);
+}
+
+stimer_handle stimer_ctx_self(struct stimer_ctx *ctx)
+{
+	return ctx ? ctx->current : NULL;
+}
 
-	for (int i = 0; i < MAX_DEFER_TASK; i++)
-		defer_pool[i] = (struct stimer_task){ .reserved = 1 };
+stimer_handle stimer_task_create_static(struct stimer_task *tcb, const struct stimer_task_attr *attr)
+{
+	if (!tcb || !attr)
+		return NULL;
 
-	for (uint8_t i = 0; i < STIMER_TASK_HIT_LIST_MAX; i++)
-		list_init(&(m_timer.hit_task_list[i]));
+	if (attr->init_f)
+		attr->init_f();
 
-	port->f_init(STIMER_PERIOD_PER_TICK_MS, _timer_update);
-	m_timer.f_start = port->f_start;
-	return true;
+	if (!attr->task_f || attr->overrun > STIMER_OVERRUN_COALESCE || !stimer_task_tier_valid(&m_timer, attr))
+		return NULL;
+
+#if STIMER_ENABLE_BUDGET
+	if (!stimer_task_admit(&m_timer, attr))
+		return NULL;
+#endif
+
+	*tcb = (struct stimer_task){ .is_static = 1 };
+	stimer_task_setup(&m_timer, tcb, attr);
+	return tcb;
+}
+
+stimer_handle stimer_task_create_ex(const struct stimer_task_attr *attr)
+{
+	return stimer_ctx_task_create(&m_timer, attr);
 }
 
 bool stimer_task_create(stimer_f init_f, stimer_f task_f, uint32_t period_ms)
 {
-	if (init_f)
-		init_f();
+	struct stimer_task_attr attr = {
+		.init_f = init_f,
+		.task_f = task_f,
+		.period_ms = period_ms,
+		.overrun = STIMER_OVERRUN_CATCH_UP,
+	};
+
+	return stimer_task_create_ex(&attr) != NULL;
+}
+
+bool stimer_task_get_stat(stimer_handle task, struct stimer_task_stat *stat)
+{
+	if (!task || !stat)
+		return false;
+
+	*stat = task->stat;
+	return true;
+}
+
+stimer_handle stimer_task_next(stimer_handle task)
+{
+	list_item *next = task ? task->node.next : m_timer.task_list.next;
+	list_item *head = task ? &task->ctx->task_list : &m_timer.task_list;
+
+	if (!next || next == head)
+		return NULL;
+
+	return container_of(next, struct stimer_task, node);
+}
+
+enum stimer_tier stimer_task_get_tier(stimer_handle task)
+{
+	return (task && task->kind == STIMER_KIND_FAST) ? STIMER_TIER_FAST : STIMER_TIER_NORMAL;
+}
+
+const char *stimer_task_name(stimer_handle task)
+{
+	return (task && task->name) ? task->name : "-";
+}
+
+void *stimer_task_arg(stimer_handle task)
+{
+	return task ? task->arg : NULL;
+}
+
+stimer_handle stimer_self(void)
+{
+	return m_timer.current;
+}
 
-	if (!task_f || !period_ms)
+bool stimer_task_delay(stimer_handle task, uint32_t ms)
+{
+	if (!task || task->kind != STIMER_KIND_TASK || !task->period || task->suspended)
 		return false;
 
-	struct stimer_task *task = (struct stimer_task *)calloc(1, sizeof(struct stimer_task));
-	if (task) {
-		task->period = Period_to_Tick(period_ms);
-		task->reserved = 1;
-		task->task_f = task_f;
-		list_init(&(task->item));
+	// 任务执行时已经按周期重新入轮, 这里直接覆盖下一次的释放节拍
+	task->expires = task->ctx->pre_tick + Period_to_Tick(ms);
+	wheel_add(task);
+	return true;
+}
 
-		return stimer_task_add(task);
-	}
+bool stimer_task_notify(stimer_handle task)
+{
+	if (!task || task->kind != STIMER_KIND_TASK)
+		return false;
+
+	// 已在队列中等待执行, 合并为一次
+	if (__atomic_exchange_n(&task->pending, 1, __ATOMIC_ACQ_REL))
+		return true;
+
+	if (stimer_work_post(task->ctx, NULL, task))
+		return true;
+
+	__atomic_store_n(&task->pending, 0, __ATOMIC_RELEASE);
 	return false;
 }
 
+bool stimer_task_set_period(stimer_handle task, uint32_t period_ms)
+{
+	if (!task || !period_ms)
+		return false;
+
+#if STIMER_MAX_FAST_TASK > 0
+	// 快速任务的周期由节拍中断在下一个节拍应用, 在下一次执行后按新周期计算
+	if (task->kind == STIMER_KIND_FAST) {
+		__atomic_store_n(&task->period_req, Period_to_Tick(period_ms), __ATOMIC_RELEASE);
+		return true;
+	}
+#endif
+
+	if (task->kind != STIMER_KIND_TASK || !task->period)
+		return false;
+
+#if STIMER_ENABLE_GOVERNOR
+	task->base_period = Period_to_Tick(period_ms);
+	stimer_task_apply_period(task, stimer_task_shed_period(task, task->ctx->shed_level));
+#else
+	stimer_task_apply_period(task, Period_to_Tick(period_ms));
+#endif
+	return true;
+}
+
+bool stimer_task_suspend(stimer_handle task)
+{
+	if (!task || (task->kind != STIMER_KIND_TASK && task->kind != STIMER_KIND_FAST))
+		return false;
+
+	__atomic_store_n(&task->suspended, 1, __ATOMIC_RELEASE);
+	list_delete_item(&task->item);
+	return true;
+}
+
+bool stimer_task_resume(stimer_handle task)
+{
+	if (!task || (task->kind != STIMER_KIND_TASK && task->kind != STIMER_KIND_FAST))
+		return false;
+
+	if (!task->suspended)
+		return true;
+
+	if (task->kind == STIMER_KIND_FAST) {
+		task->expires = task->ctx->cur_tick + task->period;
+		__atomic_store_n(&task->suspended, 0, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	task->suspended = 0;
+	return stimer_task_add(task);
+}
+
+#if STIMER_ENABLE_BUDGET
+void stimer_set_budget_hook(stimer_budget_hook hook)
+{
+	m_timer.budget_hook = hook;
+}
+
+bool stimer_get_sched_info(struct stimer_sched_info *info)
+{
+	if (!info)
+		return false;
+
+	stimer_sched_analyze(&m_timer, NULL, info);
+	return true;
+}
+#endif /* STIMER_ENABLE_BUDGET */
+
+uint64_t stimer_now_us(void)
+{
+	return stimer_ctx_now_us(&m_timer);
+}
+
+uint32_t stimer_now_ms(void)
+{
+	return (uint32_t)(stimer_now_us() / 1000);
+}
+
+bool stimer_work_submit(stimer_work_f f, void *arg)
+{
+	return stimer_ctx_work_submit(&m_timer, f, arg);
+}
+
+bool stimer_work_pending(void)
+{
+	return stimer_work_queued(&m_timer);
+}
+
+#if STIMER_ENABLE_PROFILE
+
+bool stimer_task_get_prof(stimer_handle task, struct stimer_task_prof *prof)
+{
+	if (!task || !prof)
+		return false;
+
+	struct stimer_ctx *ctx = task->ctx;
+	struct stimer_prof_data data = task->prof;
+
+	prof->count = data.count;
+	prof->exec_min = PROF_CYCLE_TO_US(ctx, data.exec_min);
+	prof->exec_max = PROF_CYCLE_TO_US(ctx, data.exec_max);
+	prof->exec_avg = data.count ? PROF_CYCLE_TO_US(ctx, data.exec_sum / data.count) : 0;
+	prof->latency_max = PROF_CYCLE_TO_US(ctx, data.latency_max);
+	prof->latency_avg = data.count ? PROF_CYCLE_TO_US(ctx, data.latency_sum / data.count) : 0;
+	return true;
+}
+
+void stimer_get_load(struct stimer_load *load)
+{
+	struct stimer_ctx *ctx = &m_timer;
+
+	if (!load)
+		return;
+
+	uint64_t busy = ctx->busy_cycle;
+	uint64_t total = busy + ctx->idle_cycle;
+
+	load->busy_us = PROF_CYCLE_TO_US(ctx, busy);
+	load->idle_us = PROF_CYCLE_TO_US(ctx, ctx->idle_cycle);
+	load->usage = total ? (uint16_t)(busy * 1000 / total) : 0;
+	load->fast_us = PROF_CYCLE_TO_US(ctx, ctx->fast_cycle);
+	load->fast_usage = total ? (uint16_t)(ctx->fast_cycle * 1000 / total) : 0;
+}
+
+void stimer_prof_reset(void)
+{
+	struct stimer_ctx *ctx = &m_timer;
+	struct stimer_task *task = NULL;
+
+	while ((task = stimer_task_next(task)) != NULL)
+		task->prof = (struct stimer_prof_data){ 0 };
+
+	ctx->busy_cycle = 0;
+	ctx->idle_cycle = 0;
+	ctx->fast_cycle = 0;
+}
+
+#if STIMER_ENABLE_GOVERNOR
+
+uint8_t stimer_get_shed_level(void)
+{
+	return m_timer.shed_level;
+}
+
+#endif /* STIMER_ENABLE_GOVERNOR */
+
+#endif /* STIMER_ENABLE_PROFILE */
+
+stimer_timer_handle stimer_timer_create(stimer_work_f f, void *arg)
+{
+	return stimer_ctx_timer_create(&m_timer, f, arg);
+}
+
+bool stimer_timer_start(stimer_timer_handle timer, uint32_t ms)
+{
+	if (!timer || timer->kind != STIMER_KIND_TIMER)
+		return false;
+
+	// 已启动时重新计时
+	timer->expires = stimer_get_tick(timer->ctx) + Period_to_Tick(ms);
+	wheel_add(timer);
+	return true;
+}
+
+bool stimer_timer_stop(stimer_timer_handle timer)
+{
+	if (!timer || timer->kind != STIMER_KIND_TIMER)
+		return false;
+
+	list_delete_item(&timer->item);
+	return true;
+}
+
+bool stimer_timer_is_active(stimer_timer_handle timer)
+{
+	return timer && timer->kind == STIMER_KIND_TIMER && timer->item.next;
+}
+
+void stimer_timer_delete(stimer_timer_handle timer)
+{
+	if (timer && timer->kind == STIMER_KIND_TIMER)
+		timer_free(timer);
+}
+
 bool defer_task_create(stimer_f task_f, uint32_t ms)
 {
-	if (!is_timer_run())
+	struct stimer_ctx *ctx = &m_timer;
+
+	if (!is_timer_run(ctx))
 		return false;
 
-	struct stimer_task *p_task = defer_task_allocate();
+	struct stimer_task *p_task = timer_allocate(ctx, STIMER_KIND_DEFER);
 	if (!p_task)
 		return false;
 
 	p_task->task_f = task_f;
-	p_task->period = Period_to_Tick(ms);
-	p_task->arrive = 0;
-	p_task->reserved = 0;
-	list_add_tail(&(m_timer.defer_task_list), &(p_task->item));
+	p_task->expires = stimer_get_tick(ctx) + Period_to_Tick(ms);
+	wheel_add(p_task);
 	return true;
 }
 
 void stimer_start(void)
 {
-	if (!m_timer.f_start)
+	struct stimer_ctx *ctx = &m_timer;
+
+	if (!ctx->f_start)
 		return;
 
-	m_timer.f_start();
-	m_timer.run_flag = 1;
+	ctx->f_start();
+	ctx->run_flag = 1;
 
-	uint32_t pre_tick = stimer_get_tick();
-	uint32_t cur_tick;
+	// 追赶所有未处理的节拍, 任务执行超时期间累积的节拍在此一次性处理完, 之后进入休眠
+#if STIMER_ENABLE_PROFILE
+	ctx->mark_cycle = prof_get_cycle(ctx);
+#endif
 
 	while (1) {
-		cur_tick = stimer_get_tick();
-		if (cur_tick != pre_tick) {
-			pre_tick = cur_tick;
-			stimer_task_dispatch();
+		if (ctx->pre_tick != stimer_get_tick(ctx) || stimer_work_queued(ctx)) {
+#if STIMER_ENABLE_PROFILE
+			prof_mark(ctx, false);
+#endif
+			stimer_work_run(ctx);
+			while (ctx->pre_tick != stimer_get_tick(ctx))
+				stimer_task_dispatch(ctx);
+#if STIMER_ENABLE_PROFILE
+			prof_mark(ctx, true);
+#endif
 		}
+
+#if STIMER_ENABLE_GOVERNOR
+		stimer_governor_update(ctx);
+#endif
+
+		stimer_idle(ctx);
 	}
 }